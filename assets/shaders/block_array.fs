@@ -0,0 +1,120 @@
+#version 330 core
+//Chunk meshes of any block type, each face picks its layer of the block texture array
+out vec4 FragColor;
+
+struct Material {
+	sampler2DArray diffuse;
+	sampler2D specular;
+	float shininess;
+};
+
+struct DirectionalLight
+{
+    vec3 direction;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct PointLight {
+    vec3 position;  
+  
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+	
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+in vec2 fragmentUV;
+in vec3 fragmentPos;
+in vec3 fragmentNormal;
+flat in float fragmentLayer;
+
+uniform vec3 COLOR;
+uniform Material MATERIAL;
+
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
+
+layout(std140) uniform LightData
+{
+    DirectionalLight DIRECTIONALLIGHT;
+    PointLight POINTLIGHTS[4];
+    int NUMBEROFPOINTLIGHTS;
+};
+
+vec3 CalculateDirectionalLight(DirectionalLight _directionalLight);
+vec3 CalculatePointLight(PointLight _pointLight);
+
+void main() {
+	// base color
+	vec4 color = texture(MATERIAL.diffuse, vec3(fragmentUV, fragmentLayer)) * vec4(COLOR, 1.0);
+
+    if (color.a <= 0.0)
+    {
+        discard;
+    }
+
+	vec3 result = CalculateDirectionalLight(DIRECTIONALLIGHT);
+
+	for(int i = 0; i < NUMBEROFPOINTLIGHTS; i++)
+		result += CalculatePointLight(POINTLIGHTS[i]);
+
+	FragColor = color * vec4(result, 1.0);
+}
+
+vec3 CalculateDirectionalLight(DirectionalLight _directionalLight)
+{
+    // ambient
+    vec3 ambient = _directionalLight.ambient;
+  	
+    // diffuse 
+    vec3 norm = normalize(fragmentNormal);
+    vec3 lightDir = normalize(-_directionalLight.direction);  
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = _directionalLight.diffuse * diff;  
+    
+    // specular
+    vec3 viewDir = normalize(VIEWPOS - fragmentPos);
+    vec3 reflectDir = reflect(-lightDir, norm);  
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), MATERIAL.shininess);
+    vec3 specular = _directionalLight.specular * spec * texture(MATERIAL.specular, fragmentUV).rgb;  
+        
+    return ambient + diffuse + specular;
+}
+
+vec3 CalculatePointLight(PointLight _pointLight)
+{
+	// ambient
+    vec3 ambient = _pointLight.ambient;
+  	
+    // diffuse 
+    vec3 norm = normalize(fragmentNormal);
+    vec3 lightDir = normalize(_pointLight.position - fragmentPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = _pointLight.diffuse * diff;  
+    
+    // specular
+    vec3 viewDir = normalize(VIEWPOS - fragmentPos);
+    vec3 reflectDir = reflect(-lightDir, norm);  
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), MATERIAL.shininess);
+    vec3 specular = _pointLight.specular * spec * texture(MATERIAL.specular, fragmentUV).rgb;  
+    
+    // attenuation
+    float distance    = length(_pointLight.position - fragmentPos);
+    float attenuation = 1.0 / (_pointLight.constant + _pointLight.linear * distance + _pointLight.quadratic * (distance * distance));    
+
+    ambient  *= attenuation;  
+    diffuse   *= attenuation;
+    specular *= attenuation;   
+        
+    return ambient + diffuse + specular;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#version 330 core
+
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec2 aUV;
+layout(location = 8) in float aLayer;
+
+out vec2 fragmentUV;
+out vec3 fragmentPos;
+out vec3 fragmentNormal;
+flat out float fragmentLayer;
+
+uniform mat4 TRANSFORM;
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
+
+void main()
+{
+    fragmentPos = vec3(TRANSFORM * vec4(aPosition, 1.0));
+    fragmentNormal = aNormal;
+    fragmentUV = vec2(aUV.x, -aUV.y);
+    fragmentLayer = aLayer;
+    gl_Position = PROJECTION * VIEW * vec4(fragmentPos, 1.0);
+}
@@ -7,9 +7,12 @@ in vec2 fragmentUV;
 uniform sampler2D uSideTex;    // GL_TEXTURE0
 uniform sampler2D uTopTex;     // GL_TEXTURE1
 uniform sampler2D uBottomTex;  // GL_TEXTURE2
+#ifdef INSTANCED
+in vec3 fragmentColor;
+#define COLOR fragmentColor
+#else
 uniform vec3 COLOR;
-uniform vec3 VIEWPOS;
-uniform float TIME;
+#endif
 
 // Light structures
 struct DirectionalLight {
@@ -35,9 +38,21 @@ struct Material {
 };
 
 // Uniforms for lighting
-uniform DirectionalLight DIRECTIONALLIGHT;
-uniform PointLight POINTLIGHTS[4];
-uniform int NUMBEROFPOINTLIGHTS;
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
+
+layout(std140) uniform LightData
+{
+    DirectionalLight DIRECTIONALLIGHT;
+    PointLight POINTLIGHTS[4];
+    int NUMBEROFPOINTLIGHTS;
+};
+
 uniform Material MATERIAL;
 
 out vec4 FragColor;
@@ -4,10 +4,21 @@ layout(location = 0) in vec3 aPosition;
 layout(location = 1) in vec3 aNormal;
 layout(location = 2) in vec2 aTexCoords;
 
+#ifdef INSTANCED
+layout(location = 3) in mat4 aInstanceTransform;
+layout(location = 7) in vec3 aInstanceColor;
+out vec3 fragmentColor;
+#define TRANSFORM aInstanceTransform
+#else
 uniform mat4 TRANSFORM;
-uniform mat4 VIEW;
-uniform mat4 PROJECTION;
-uniform float TIME;
+#endif
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
 uniform bool WIND;
 uniform float WINDEFFECT;
 
@@ -34,4 +45,7 @@ void main() {
     
     // Calculate final position
     gl_Position = PROJECTION * VIEW * TRANSFORM * vec4(windPos, 1.0);
+#ifdef INSTANCED
+    fragmentColor = aInstanceColor;
+#endif
 }
\ No newline at end of file
@@ -7,13 +7,38 @@ uniform sampler2D uSideTex;    // GL_TEXTURE0
 uniform sampler2D uTopTex;     // GL_TEXTURE1
 uniform sampler2D uBottomTex;  // GL_TEXTURE2
 
-// your lighting uniforms
-uniform vec3 VIEWPOS;
-struct PointLight { /* … */ };
-uniform int  NUMBEROFPOINTLIGHTS;
-uniform PointLight POINTLIGHTS[16];
-struct DirectionalLight { /* … */ };
-uniform DirectionalLight DIRECTIONALLIGHT;
+// your lighting uniforms, filled once per frame by World
+struct DirectionalLight {
+    vec3 direction;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+struct PointLight {
+    vec3 position;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+    float constant;
+    float linear;
+    float quadratic;
+};
+
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
+
+layout(std140) uniform LightData
+{
+    DirectionalLight DIRECTIONALLIGHT;
+    PointLight POINTLIGHTS[4];
+    int NUMBEROFPOINTLIGHTS;
+};
 
 out vec4 FragColor;
 
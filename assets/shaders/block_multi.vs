@@ -9,8 +9,13 @@ out vec2 fragmentUV;
 out vec3 fragmentPos;
 
 uniform mat4 TRANSFORM;
-uniform mat4 VIEW;
-uniform mat4 PROJECTION;
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
 
 void main() {
     fragmentNormal = mat3(transpose(inverse(TRANSFORM))) * aNormal;
@@ -3,7 +3,7 @@
 out vec4 FragColor;
 
 struct Material {
-    sampler2D diffuse;  // Single texture for current animation frame
+    sampler2DArray diffuse;  // Every animation frame, one per layer
     sampler2D specular;
     float shininess;
 };
@@ -12,13 +12,26 @@ in vec2 fragmentUV;
 in vec3 fragmentPos;
 in vec3 fragmentNormal;
 
+#ifdef INSTANCED
+in vec3 fragmentColor;
+#define COLOR fragmentColor
+#else
 uniform vec3 COLOR;
+#endif
 uniform Material MATERIAL;
-uniform float TIME;
+uniform int FRAME;  // Layer of the current animation frame
+
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
 
 void main() {
     // Get the current texture color
-    vec4 texColor = texture(MATERIAL.diffuse, fragmentUV);
+    vec4 texColor = texture(MATERIAL.diffuse, vec3(fragmentUV, FRAME));
     
     // Discard fully transparent pixels
     if (texColor.a < 0.1)
@@ -32,14 +32,28 @@ in vec2 fragmentUV;
 in vec3 fragmentPos;
 in vec3 fragmentNormal;
 
+#ifdef INSTANCED
+in vec3 fragmentColor;
+#define COLOR fragmentColor
+#else
 uniform vec3 COLOR;
+#endif
 uniform Material MATERIAL;
-uniform DirectionalLight DIRECTIONALLIGHT;
-uniform PointLight POINTLIGHTS[4];
-uniform int NUMBEROFPOINTLIGHTS;
-uniform float TIME;
 
-uniform vec3 VIEWPOS;
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
+
+layout(std140) uniform LightData
+{
+    DirectionalLight DIRECTIONALLIGHT;
+    PointLight POINTLIGHTS[4];
+    int NUMBEROFPOINTLIGHTS;
+};
 
 vec3 CalculateDirectionalLight(DirectionalLight _directionalLight);
 vec3 CalculatePointLight(PointLight _pointLight);
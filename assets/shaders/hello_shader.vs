@@ -8,22 +8,38 @@ out vec2 fragmentUV;
 out vec3 fragmentPos;
 out vec3 fragmentNormal;
 
+#ifdef INSTANCED
+layout(location = 3) in mat4 aInstanceTransform;
+layout(location = 7) in vec3 aInstanceColor;
+out vec3 fragmentColor;
+#define TRANSFORM aInstanceTransform
+#else
 uniform mat4 TRANSFORM;
-uniform mat4 VIEW;
-uniform mat4 PROJECTION;
-uniform float TIME;
-uniform bool WIND;
+#endif
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
+#ifdef WIND
 uniform float WINDEFFECT;
+#endif
 
 void main()
 {
     float offset = 0.0;
 
-    if (WIND)
-        offset = sin(TIME) * (aPosition.y + 0.5) * WINDEFFECT;
+#ifdef WIND
+    offset = sin(TIME) * (aPosition.y + 0.5) * WINDEFFECT;
+#endif
 
     fragmentPos = vec3(TRANSFORM * vec4(aPosition + vec3(offset, 0.0, offset), 1.0));
     fragmentNormal = aNormal;
     fragmentUV = vec2(aUV.x, -aUV.y);
     gl_Position = PROJECTION * VIEW * vec4(fragmentPos, 1.0);
+#ifdef INSTANCED
+    fragmentColor = aInstanceColor;
+#endif
 }
\ No newline at end of file
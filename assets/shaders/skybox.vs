@@ -3,12 +3,18 @@ layout (location = 0) in vec3 aPosition;
 
 out vec3 texCoords;
 
-uniform mat4 PROJECTION;
-uniform mat4 VIEW;
+layout(std140) uniform FrameData
+{
+    mat4 VIEW;
+    mat4 PROJECTION;
+    vec3 VIEWPOS;
+    float TIME;
+};
 
 void main()
 {
     texCoords = aPosition;
-    vec4 pos = PROJECTION * VIEW * vec4(aPosition, 1.0);
+    // the cast to mat3 removes position of the camera as a factor
+    vec4 pos = PROJECTION * mat4(mat3(VIEW)) * vec4(aPosition, 1.0);
     gl_Position = pos.xyww;
 }
\ No newline at end of file
@@ -0,0 +1,1157 @@
+#include "Benchmarks.hpp"
+#include <glm/glm.hpp>
+#include <string>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <filesystem>
+#include <thread>
+#include <unordered_map>
+#include "Canis/Canis.hpp"
+#include "Canis/Entity.hpp"
+#include "Canis/EntityStorage.hpp"
+#include "Canis/Debug.hpp"
+#include "Canis/IOManager.hpp"
+#include "Canis/ChunkMesher.hpp"
+#include "Canis/BlockRegistry.hpp"
+#include "Canis/MeshOptimizer.hpp"
+#include "Canis/MeshFile.hpp"
+#include "Canis/TextureFile.hpp"
+#include "Canis/AssetPack.hpp"
+#include "Canis/Task.hpp"
+#include "Canis/ThreadPool.hpp"
+#include "Canis/VoxelGrid.hpp"
+#include "Canis/MapFile.hpp"
+#include "Canis/SparseVoxelGrid.hpp"
+#include "Canis/PaletteChunk.hpp"
+#include "Canis/ChunkStreamer.hpp"
+#include "Canis/TerrainGenerator.hpp"
+#include "Level.hpp"
+
+using namespace glm;
+
+// the vertices of one chunk, as MeshChunks returns them
+struct ChunkVertices
+{
+    glm::ivec3 chunk;
+    std::vector<float> vertices;
+};
+
+// declaring functions
+std::vector<ChunkVertices> MeshChunks(const Canis::BlockInfo *_blockInfo, Canis::MeshingMode _mode);
+void BenchmarkMeshing();
+void BenchmarkEntities();
+void WriteBenchmarkGrid(const std::string &_path);
+void BenchmarkMeshCache();
+void BenchmarkTextureCache();
+void BenchmarkAssetPack();
+Canis::Task<void> LoadLevelHeadless(const std::vector<std::string> &_imagePaths, const Canis::BlockInfo *_blockInfo);
+void BenchmarkAsyncLoading();
+void BenchmarkMapLoading();
+bool BenchmarkTerrain();
+bool BenchmarkStreaming();
+bool BenchmarkSparseVoxels();
+bool BenchmarkPaletteChunks();
+void BenchmarkOBJ();
+void BenchmarkIndexing();
+
+bool RunBenchmarks()
+{
+    BenchmarkMeshing();
+    BenchmarkEntities();
+    BenchmarkOBJ();
+    BenchmarkIndexing();
+    BenchmarkMeshCache();
+    BenchmarkTextureCache();
+    BenchmarkAssetPack();
+    BenchmarkAsyncLoading();
+    BenchmarkMapLoading();
+    bool passed = BenchmarkTerrain();
+    passed &= BenchmarkStreaming();
+    passed &= BenchmarkSparseVoxels();
+    passed &= BenchmarkPaletteChunks();
+    return passed;
+}
+
+// every chunk of the map that has faces, only reads the map so it can run on the thread pool
+std::vector<ChunkVertices> MeshChunks(const Canis::BlockInfo *_blockInfo, Canis::MeshingMode _mode)
+{
+    glm::ivec3 chunkCount = map.GetChunkCount();
+
+    std::vector<uint8_t> paddedBlocks(Canis::CHUNK_PADDED_VOLUME);
+    std::vector<ChunkVertices> meshes;
+
+    for (int cy = 0; cy < chunkCount.y; cy++)
+    {
+        for (int cx = 0; cx < chunkCount.x; cx++)
+        {
+            for (int cz = 0; cz < chunkCount.z; cz++)
+            {
+                ChunkVertices mesh;
+                mesh.chunk = glm::ivec3(cx, cy, cz);
+
+                map.CopyPaddedChunk(mesh.chunk, paddedBlocks.data());
+                Canis::BuildChunkMesh(paddedBlocks.data(), _blockInfo, mesh.vertices, _mode);
+
+                if (!mesh.vertices.empty())
+                    meshes.push_back(std::move(mesh));
+            }
+        }
+    }
+
+    return meshes;
+}
+
+// meshes every chunk of the level maps and of a generated 256x64x256 map with both modes
+void BenchmarkMeshing()
+{
+    Canis::BlockRegistry blocks;
+    SetupBlocks(blocks);
+
+    const char *mapNames[3] = {"assets/maps/level.map", "assets/maps/level1.map", "synthetic 256x64x256"};
+    const int REPEAT = 5;
+
+    std::vector<uint8_t> paddedBlocks(Canis::CHUNK_PADDED_VOLUME);
+    std::vector<float> vertices;
+
+    for (int m = 0; m < 3; m++)
+    {
+        if (m < 2)
+        {
+            Canis::LoadMap(mapNames[m], map);
+        }
+        else
+        {
+            // rolling dirt hills with brick and glass pillars
+            srand(1);
+            map.Resize(256, 64, 256);
+            for (int x = 0; x < 256; x++)
+            {
+                for (int z = 0; z < 256; z++)
+                {
+                    int height = 24 + (int)(8.0f * sin(x * 0.05f) + 8.0f * cos(z * 0.07f));
+                    for (int y = 0; y < height; y++)
+                        map.Set(x, y, z, 4);
+
+                    if (rand() % 200 == 0)
+                        for (int y = height; y < height + 6; y++)
+                            map.Set(x, y, z, (rand() % 2) ? 5 : 1);
+                }
+            }
+        }
+
+        glm::ivec3 chunkCount = map.GetChunkCount();
+
+        for (Canis::MeshingMode mode : {Canis::MeshingMode::PER_FACE, Canis::MeshingMode::GREEDY})
+        {
+            unsigned int triangles = 0;
+            double seconds = 0.0;
+
+            for (int r = 0; r < REPEAT; r++)
+            {
+                triangles = 0;
+
+                for (int cy = 0; cy < chunkCount.y; cy++)
+                {
+                    for (int cx = 0; cx < chunkCount.x; cx++)
+                    {
+                        for (int cz = 0; cz < chunkCount.z; cz++)
+                        {
+                            map.CopyPaddedChunk(glm::ivec3(cx, cy, cz), paddedBlocks.data());
+
+                            auto start = std::chrono::high_resolution_clock::now();
+                            Canis::BuildChunkMesh(paddedBlocks.data(), blocks.GetBlockInfo(), vertices, mode);
+                            seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+                            triangles += vertices.size() / (3 * Canis::CHUNK_VERTEX_FLOATS);
+                        }
+                    }
+                }
+            }
+
+            Canis::Log(std::string(mapNames[m]) +
+                       ((mode == Canis::MeshingMode::GREEDY) ? " greedy" : " per face") +
+                       " triangles: " + std::to_string(triangles) +
+                       " vertex KB: " + std::to_string(triangles * 3 * Canis::CHUNK_VERTEX_FLOATS * sizeof(float) / 1024) +
+                       " mesh ms: " + std::to_string(seconds * 1000.0 / REPEAT));
+        }
+    }
+
+    map.Clear();
+}
+
+// moves every active entity then tests its bounds against a sphere, stored as std::vector<Entity> and as EntityStorage
+void BenchmarkEntities()
+{
+    const int REPEAT = 20;
+    Canis::Model model;
+    model.boundsMin = vec3(-0.5f);
+    model.boundsMax = vec3(0.5f);
+
+    for (int count : {100000, 1000000})
+    {
+        std::vector<Canis::Entity> entityArray;
+        Canis::EntityStorage entityStorage;
+
+        for (int i = 0; i < count; i++)
+        {
+            Canis::Entity entity;
+            entity.active = (i % 10) != 0;
+            entity.tag = "benchmark entity";
+            entity.model = &model;
+            entity.transform.position = vec3(i % 100, (i / 100) % 100, i / 10000);
+            entityArray.push_back(entity);
+            entityStorage.Spawn(entity);
+        }
+
+        vec3 center = vec3(50.0f);
+        float radius = 25.0f;
+
+        unsigned int visibleArray = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < REPEAT; r++)
+        {
+            visibleArray = 0;
+            for (Canis::Entity &entity : entityArray)
+            {
+                if (!entity.active)
+                    continue;
+
+                entity.transform.position.y += 0.001f;
+                vec3 offset = entity.transform.position + (entity.model->boundsMin + entity.model->boundsMax) * 0.5f - center;
+                if (dot(offset, offset) < radius * radius)
+                    visibleArray++;
+            }
+        }
+        double arraySeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::vector<uint8_t> &active = entityStorage.GetActive();
+        std::vector<Canis::Transform> &transforms = entityStorage.GetTransforms();
+        std::vector<Canis::RenderData> &renderData = entityStorage.GetRenderData();
+
+        unsigned int visibleStorage = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < REPEAT; r++)
+        {
+            visibleStorage = 0;
+            for (unsigned int i = 0; i < entityStorage.Size(); i++)
+            {
+                if (!active[i])
+                    continue;
+
+                transforms[i].position.y += 0.001f;
+                Canis::Model &entityModel = *renderData[i].model;
+                vec3 offset = transforms[i].position + (entityModel.boundsMin + entityModel.boundsMax) * 0.5f - center;
+                if (dot(offset, offset) < radius * radius)
+                    visibleStorage++;
+            }
+        }
+        double storageSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        if (visibleArray != visibleStorage)
+            Canis::Error("Entity benchmark results do not match");
+
+        double arrayRate = count * (double)REPEAT / arraySeconds / 1000000.0;
+        double storageRate = count * (double)REPEAT / storageSeconds / 1000000.0;
+
+        Canis::Log(std::to_string(count) + " entities std::vector<Entity>: " + std::to_string(arrayRate) +
+                   " M/s EntityStorage: " + std::to_string(storageRate) + " M/s (" +
+                   std::to_string(sizeof(Canis::Entity)) + " vs " +
+                   std::to_string(sizeof(uint8_t) + sizeof(Canis::Transform) + sizeof(Canis::RenderData)) + " bytes touched per entity)");
+    }
+}
+
+// a 708x708 quad height field, 1M triangles with only v/vt/vn corners so the old parser can read it
+void WriteBenchmarkGrid(const std::string &_path)
+{
+    const int GRID = 708;
+    std::ofstream grid(_path);
+    for (int z = 0; z <= GRID; z++)
+        for (int x = 0; x <= GRID; x++)
+            grid << "v " << x * 0.1f << " " << sin(x * 0.05f) * cos(z * 0.05f) << " " << z * -0.1f << "\n";
+    for (int z = 0; z <= GRID; z++)
+        for (int x = 0; x <= GRID; x++)
+            grid << "vt " << x / (float)GRID << " " << z / (float)GRID << "\n";
+    grid << "vn 0.000000 1.000000 0.000000\n";
+    for (int z = 0; z < GRID; z++)
+    {
+        for (int x = 0; x < GRID; x++)
+        {
+            int a = z * (GRID + 1) + x + 1;
+            int b = a + 1;
+            int c = a + GRID + 1;
+            int d = c + 1;
+            grid << "f " << a << "/" << a << "/1 " << c << "/" << c << "/1 " << b << "/" << b << "/1\n";
+            grid << "f " << b << "/" << b << "/1 " << c << "/" << c << "/1 " << d << "/" << d << "/1\n";
+        }
+    }
+}
+
+// cpu side of LoadModel from the obj, on the run that writes the .cmesh and from the mapped .cmesh
+void BenchmarkMeshCache()
+{
+    std::string gridPath = (std::filesystem::temp_directory_path() / "canis_benchmark_grid.obj").string();
+    WriteBenchmarkGrid(gridPath);
+
+    const char *paths[4] = {"assets/models/cube.obj", "assets/models/plants.obj", "assets/models/fire.obj", gridPath.c_str()};
+
+    for (int m = 0; m < 4; m++)
+    {
+        std::filesystem::remove(Canis::GetMeshCachePath(paths[m]));
+
+        auto start = std::chrono::high_resolution_clock::now();
+        {
+            Canis::MeshData mesh;
+            Canis::LoadMeshData(paths[m], mesh, false);
+        }
+        double objSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        {
+            Canis::MeshData mesh;
+            Canis::LoadMeshData(paths[m], mesh, true);
+        }
+        double writeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        // glBufferData reads every page of the mapping, touch them so the lazy mapping is not free
+        start = std::chrono::high_resolution_clock::now();
+        Canis::MeshData mesh;
+        Canis::LoadMeshData(paths[m], mesh, true);
+        volatile float touched = 0.0f;
+        for (size_t i = 0; i < (size_t)mesh.vertexCount * mesh.vertexStride / sizeof(float); i += 1024)
+            touched = touched + mesh.vertices[i];
+        for (size_t i = 0; i < mesh.indexCount; i += 1024)
+            touched = touched + mesh.indices[i];
+        double cacheSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        if (!mesh.fromCache)
+            Canis::Warning("Mesh cache was not used for " + std::string(paths[m]));
+
+        Canis::Log(std::string((m < 3) ? paths[m] : "synthetic grid") +
+                   " obj: " + std::to_string(objSeconds * 1000.0) + " ms" +
+                   " obj + write .cmesh: " + std::to_string(writeSeconds * 1000.0) + " ms" +
+                   " .cmesh: " + std::to_string(cacheSeconds * 1000.0) + " ms");
+    }
+
+    std::filesystem::remove(Canis::GetMeshCachePath(gridPath));
+    std::filesystem::remove(gridPath);
+}
+
+// cpu side of loading a texture with its mips, png decode + box filter against the mapped .ctex
+void BenchmarkTextureCache()
+{
+    std::vector<std::string> firePaths = GetFirePaths();
+
+    std::vector<std::pair<std::string, std::vector<std::string>>> sets = {
+        {"assets/textures/grass.png", {"assets/textures/grass.png"}},
+        {"assets/textures/container2_specular.png", {"assets/textures/container2_specular.png"}},
+        {"assets/textures/house.png", {"assets/textures/house.png"}},
+        {"fire flipbook", firePaths},
+    };
+
+    for (const auto &set : sets)
+    {
+        for (const std::string &path : set.second)
+            std::filesystem::remove(Canis::GetTextureCachePath(path));
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const std::string &path : set.second)
+        {
+            Canis::TextureData texture;
+            Canis::LoadTextureData(path, 4, true, texture, false);
+        }
+        double decodeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        for (const std::string &path : set.second)
+        {
+            Canis::TextureData texture;
+            Canis::LoadTextureData(path, 4, true, texture, true);
+        }
+        double writeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        // glTexImage2D reads every page of every level, touch them so the lazy mapping is not free
+        start = std::chrono::high_resolution_clock::now();
+        volatile int touched = 0;
+        size_t bytes = 0;
+        for (const std::string &path : set.second)
+        {
+            Canis::TextureData texture;
+            Canis::LoadTextureData(path, 4, true, texture, true);
+
+            if (!texture.fromCache)
+                Canis::Warning("Texture cache was not used for " + path);
+
+            for (int level = 0; level < texture.levelCount; level++)
+            {
+                size_t size = (size_t)texture.levels[level].width * texture.levels[level].height * texture.channels;
+                for (size_t i = 0; i < size; i += 4096)
+                    touched = touched + texture.levels[level].pixels[i];
+                bytes += size;
+            }
+        }
+        double cacheSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        Canis::Log(set.first + " " + std::to_string(bytes / 1024) + " KB with mips" +
+                   " png + mips: " + std::to_string(decodeSeconds * 1000.0) + " ms" +
+                   " png + mips + write .ctex: " + std::to_string(writeSeconds * 1000.0) + " ms" +
+                   " .ctex: " + std::to_string(cacheSeconds * 1000.0) + " ms");
+    }
+}
+
+// opening and reading every file under assets/ loose and from a pack
+// each loose file costs open, fstat, mmap, madvise, close and munmap, the pack costs them once
+void BenchmarkAssetPack()
+{
+    bool mounted = Canis::IsAssetPackMounted();
+    Canis::UnmountAssetPack();
+
+    std::string packPath = (std::filesystem::temp_directory_path() / "canis_benchmark.cpak").string();
+    if (!Canis::BuildAssetPack("assets", packPath))
+        return;
+
+    std::vector<std::string> paths;
+    for (const auto &file : std::filesystem::recursive_directory_iterator("assets"))
+        if (file.is_regular_file() && file.path().extension().string().compare(0, 4, ".tmp") != 0)
+            paths.push_back(file.path().generic_string());
+
+    const int repeat = 20;
+    double seconds[2] = {};
+    size_t bytes = 0;
+    volatile int touched = 0;
+
+    for (int packed = 0; packed < 2; packed++)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < repeat; r++)
+        {
+            if (packed)
+                Canis::MountAssetPack(packPath);
+
+            bytes = 0;
+            for (const std::string &path : paths)
+            {
+                Canis::VirtualFile file;
+                if (!file.Open(path))
+                    continue;
+
+                for (size_t i = 0; i < file.GetSize(); i += 4096)
+                    touched = touched + file.GetData()[i];
+                bytes += file.GetSize();
+            }
+
+            Canis::UnmountAssetPack();
+        }
+        seconds[packed] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / repeat;
+    }
+
+    Canis::Log(std::to_string(paths.size()) + " files " + std::to_string(bytes / 1024) + " KB" +
+               " loose: " + std::to_string(paths.size()) + " files opened " + std::to_string(seconds[0] * 1000.0) + " ms" +
+               " pack: 1 file opened " + std::to_string(seconds[1] * 1000.0) + " ms");
+
+    std::filesystem::remove(packPath);
+
+    if (mounted)
+        Canis::MountAssetPack(Canis::GetConfig().assetPack);
+}
+
+// the cpu steps of LoadLevel, the benchmark has no window for the uploads between them
+Canis::Task<void> LoadLevelHeadless(const std::vector<std::string> &_imagePaths, const Canis::BlockInfo *_blockInfo)
+{
+    auto prepare = [&]() { PrepareLevelAssets(_imagePaths, false, false); };
+    co_await Canis::RunOnPool(prepare);
+
+    const char *shaders[6] = {"assets/shaders/hello_shader.vs", "assets/shaders/hello_shader.fs", "assets/shaders/block_array.vs",
+                              "assets/shaders/block_array.fs", "assets/shaders/fire_shader.vs", "assets/shaders/fire_shader.fs"};
+    for (const char *path : shaders)
+    {
+        std::unique_ptr<Canis::VirtualFile> file = co_await Canis::ReadFileAsync(path);
+        if (file == nullptr)
+            Canis::Warning("Can not read " + std::string(path));
+    }
+
+    auto loadMap = []() { return LoadLevelMap(); };
+    co_await Canis::RunOnPool(loadMap);
+
+    auto mesh = [&]() { return MeshChunks(_blockInfo, Canis::MeshingMode::GREEDY); };
+    std::vector<ChunkVertices> meshes = co_await Canis::RunOnPool(mesh);
+}
+
+// loads every asset of the level with the caches off, once on the frame thread and once as a task while a 60 fps loop ticks
+// the worst frame of the loop is what loading costs the player, the blocking load is one frame of that length
+void BenchmarkAsyncLoading()
+{
+    Canis::BlockRegistry blocks;
+    SetupBlocks(blocks);
+    std::vector<std::string> imagePaths = GetLevelImagePaths(blocks);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    PrepareLevelAssets(imagePaths, false, false);
+    LoadLevelMap();
+    MeshChunks(blocks.GetBlockInfo(), Canis::MeshingMode::GREEDY);
+    double blockingSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    Canis::TaskScheduler &tasks = Canis::GetTaskScheduler();
+    const std::chrono::microseconds FRAME_TIME = std::chrono::microseconds(16667);
+    int frames = 0;
+    double worstFrame = 0.0;
+
+    start = std::chrono::high_resolution_clock::now();
+    tasks.Spawn(LoadLevelHeadless(imagePaths, blocks.GetBlockInfo()));
+
+    while (tasks.GetRunningCount() > 0)
+    {
+        auto frameStart = std::chrono::high_resolution_clock::now();
+        tasks.Update();
+        worstFrame = std::max(worstFrame, std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - frameStart).count());
+        frames++;
+
+        std::this_thread::sleep_until(frameStart + FRAME_TIME);
+    }
+    double asyncSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    Canis::Log(std::to_string(imagePaths.size()) + " images, 2 models, 6 shaders, the map and its chunks" +
+               " blocking: " + std::to_string(blockingSeconds * 1000.0) + " ms in one frame" +
+               " task: " + std::to_string(asyncSeconds * 1000.0) + " ms over " + std::to_string(frames) + " frames," +
+               " worst frame " + std::to_string(worstFrame * 1000.0) + " ms");
+}
+
+// writes _grid in the text format LoadMap reads, rows and layers are separated rather than ended so the size round trips
+bool WriteTextMap(const std::string &_path, const Canis::VoxelGrid &_grid)
+{
+    std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+    std::string layer;
+
+    for (int y = 0; y < _grid.GetSizeY(); y++)
+    {
+        layer.clear();
+        for (int x = 0; x < _grid.GetSizeX(); x++)
+        {
+            for (int z = 0; z < _grid.GetSizeZ(); z++)
+            {
+                layer += std::to_string(_grid.Get(x, y, z));
+                layer += ' ';
+            }
+
+            if (x + 1 < _grid.GetSizeX())
+                layer += "-1\n";
+        }
+
+        if (y + 1 < _grid.GetSizeY())
+            layer += "\n-2\n";
+
+        file.write(layer.data(), layer.size());
+    }
+
+    return file.good();
+}
+
+// LoadMap parsing the text maps against LoadMapFile mapping the .cmap, on the shipped maps and a generated 512x256x512 map
+void BenchmarkMapLoading()
+{
+    std::filesystem::path directory = std::filesystem::temp_directory_path();
+    std::string syntheticPath = (directory / "canis_benchmark.map").string();
+
+    // stone under dirt hills with a glass top and scattered brick pillars, most chunks are all air or all stone
+    srand(1);
+    map.Resize(512, 256, 512);
+    for (int x = 0; x < 512; x++)
+    {
+        for (int z = 0; z < 512; z++)
+        {
+            int height = 64 + (int)(16.0f * sin(x * 0.03f) + 16.0f * cos(z * 0.02f));
+            for (int y = 0; y < height; y++)
+                map.Set(x, y, z, (y < height - 4) ? 5 : 4);
+            map.Set(x, height, z, 1);
+
+            if (rand() % 500 == 0)
+                for (int y = height + 1; y < height + 8; y++)
+                    map.Set(x, y, z, 5);
+        }
+    }
+
+    if (!WriteTextMap(syntheticPath, map))
+    {
+        Canis::Error("Can not write " + syntheticPath);
+        return;
+    }
+
+    const char *mapNames[3] = {"assets/maps/level.map", "assets/maps/level1.map", "synthetic"};
+    const char *textPaths[3] = {mapNames[0], mapNames[1], syntheticPath.c_str()};
+
+    for (int m = 0; m < 3; m++)
+    {
+        std::string binaryPath = (directory / ("canis_benchmark_" + std::to_string(m) + ".cmap")).string();
+        if (!Canis::ConvertMap(textPaths[m], binaryPath))
+            continue;
+
+        // the small maps are repeated until there is something to measure
+        int repeat = (m < 2) ? 200 : 1;
+        double seconds[2] = {};
+
+        for (int binary = 0; binary < 2; binary++)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int r = 0; r < repeat; r++)
+            {
+                if (binary)
+                    Canis::LoadMapFile(binaryPath, map);
+                else
+                    Canis::LoadMap(textPaths[m], map);
+            }
+            seconds[binary] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / repeat;
+        }
+
+        Canis::Log(std::string(mapNames[m]) + " " + std::to_string(map.GetSizeX()) + "x" + std::to_string(map.GetSizeY()) + "x" + std::to_string(map.GetSizeZ()) +
+                   " text: " + std::to_string(std::filesystem::file_size(textPaths[m]) / 1024) + " KB " + std::to_string(seconds[0] * 1000.0) + " ms" +
+                   " .cmap: " + std::to_string(std::filesystem::file_size(binaryPath) / 1024) + " KB " + std::to_string(seconds[1] * 1000.0) + " ms");
+
+        std::filesystem::remove(binaryPath);
+    }
+
+    std::filesystem::remove(syntheticPath);
+    map.Clear();
+}
+
+// generates a 512x128x512 world with 1, 4 and every core, the blocks have to be the same every time
+// the padded chunks ChunkStreamer gets have to match the generated grid around them too
+bool BenchmarkTerrain()
+{
+    Canis::TerrainSettings settings;
+    settings.seed = 1;
+
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int threads[3] = {1, 4, cores};
+    double cells = 512.0 * 128.0 * 512.0;
+    uint64_t firstHash = 0;
+    bool passed = true;
+
+    for (int t = 0; t < 3; t++)
+    {
+        Canis::ThreadPool pool(threads[t]);
+        map.Resize(512, 128, 512);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        Canis::GenerateTerrain(settings, map, pool);
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        // fnv-1a over every chunk
+        uint64_t hash = 14695981039346656037ull;
+        glm::ivec3 chunkCount = map.GetChunkCount();
+        for (int cy = 0; cy < chunkCount.y; cy++)
+            for (int cx = 0; cx < chunkCount.x; cx++)
+                for (int cz = 0; cz < chunkCount.z; cz++)
+                {
+                    const uint8_t *blocks = map.GetChunkData(glm::ivec3(cx, cy, cz));
+                    for (int i = 0; i < Canis::VoxelGrid::CHUNK_VOLUME; i++)
+                        hash = (hash ^ blocks[i]) * 1099511628211ull;
+                }
+
+        if (t == 0)
+            firstHash = hash;
+
+        char hashText[17];
+        snprintf(hashText, sizeof(hashText), "%016llx", (unsigned long long)hash);
+
+        Canis::Log("Terrain 512x128x512 with " + std::to_string(threads[t]) + " threads: " + std::to_string(seconds * 1000.0) + " ms " +
+                   std::to_string(cells / seconds / 1000000.0) + " M cells/s hash " + hashText);
+
+        if (hash != firstHash)
+        {
+            Canis::Error("Terrain with " + std::to_string(threads[t]) + " threads differs from the one with 1 thread");
+            passed = false;
+        }
+    }
+
+    std::vector<uint8_t> generated(Canis::CHUNK_PADDED_VOLUME);
+    std::vector<uint8_t> copied(Canis::CHUNK_PADDED_VOLUME);
+    for (glm::ivec3 chunk : {glm::ivec3(1, 3, 1), glm::ivec3(7, 4, 12), glm::ivec3(30, 2, 30)})
+    {
+        Canis::GeneratePaddedChunk(settings, chunk, generated.data());
+        map.CopyPaddedChunk(chunk, copied.data());
+
+        if (generated != copied)
+        {
+            Canis::Error("Padded chunk " + glm::to_string(chunk) + " does not match the generated terrain");
+            passed = false;
+        }
+    }
+
+    map.Clear();
+    return passed;
+}
+
+// flies a camera over a generated 32768 block wide world at 60 fps, every chunk is generated when it is requested
+// fails when more than 1% of the frames spend over 4 ms streaming or the chunks around the camera are missing at the end
+bool BenchmarkStreaming()
+{
+    Canis::BlockRegistry blocks;
+    SetupBlocks(blocks);
+
+    const int CHUNKS_Y = 8;
+    const double FRAME_BUDGET = 0.004;
+    const std::chrono::microseconds FRAME_TIME = std::chrono::microseconds(16667);
+
+    Canis::TerrainSettings settings;
+    settings.seed = 1;
+    auto fill = [&settings](glm::ivec3 _chunk, uint8_t *_paddedBlocks) { Canis::GeneratePaddedChunk(settings, _chunk, _paddedBlocks); };
+
+    // stands in for the gpu, the game keeps a cpu copy of every chunk model too
+    std::unordered_map<uint64_t, std::vector<float>> uploaded;
+    auto load = [&](glm::ivec3 _chunk, const std::vector<float> &_vertices)
+    {
+        if (_vertices.empty())
+            uploaded.erase(Canis::ChunkKey(_chunk));
+        else
+            uploaded[Canis::ChunkKey(_chunk)] = _vertices;
+    };
+    auto evict = [&](glm::ivec3 _chunk) { uploaded.erase(Canis::ChunkKey(_chunk)); };
+
+    Canis::ChunkStreamer streamer;
+    streamer.SetRadius(8);
+    streamer.SetBudget(2048);
+    streamer.Start(blocks.GetBlockInfo(), fill, load, evict, glm::ivec3(-1024, 0, -1024), glm::ivec3(1024, CHUNKS_Y, 1024));
+
+    // 5 seconds along x weaving on z, then hover until everything around the camera is in
+    const int FLIGHT_FRAMES = 300;
+    glm::vec3 position = glm::vec3(0.0f, 80.0f, 0.0f);
+    std::vector<double> frameSeconds;
+    size_t mostResident = 0;
+    bool settled = false;
+
+    for (int frame = 0; frame < FLIGHT_FRAMES + 600 && !settled; frame++)
+    {
+        auto frameStart = std::chrono::high_resolution_clock::now();
+
+        if (frame < FLIGHT_FRAMES)
+            position += glm::vec3(64.0f, 0.0f, 48.0f * cos(frame * 0.02f)) / 60.0f;
+
+        streamer.Update(position);
+        frameSeconds.push_back(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - frameStart).count());
+        mostResident = std::max(mostResident, streamer.GetStats().residentChunks);
+
+        settled = frame >= FLIGHT_FRAMES && streamer.GetStats().pendingChunks == 0;
+        std::this_thread::sleep_until(frameStart + FRAME_TIME);
+    }
+
+    Canis::StreamingStats stats = streamer.GetStats();
+    int overBudget = std::count_if(frameSeconds.begin(), frameSeconds.end(), [&](double _seconds) { return _seconds > FRAME_BUDGET; });
+    double worstFrame = *std::max_element(frameSeconds.begin(), frameSeconds.end());
+    double averageFrame = std::accumulate(frameSeconds.begin(), frameSeconds.end(), 0.0) / frameSeconds.size();
+
+    // every chunk inside the radius should be resident where the flight ended
+    glm::ivec3 center = glm::ivec3(glm::floor(position / (float)Canis::CHUNK_SIZE));
+    int missing = 0;
+    for (int x = -8; x <= 8; x++)
+        for (int z = -8; z <= 8; z++)
+            for (int y = 0; y < CHUNKS_Y; y++)
+                if (x * x + z * z <= 64 && !streamer.IsResident(glm::ivec3(center.x + x, y, center.z + z)))
+                    missing++;
+
+    Canis::Log("Streaming flight: " + std::to_string(frameSeconds.size()) + " frames" +
+               " update avg " + std::to_string(averageFrame * 1000.0) + " ms worst " + std::to_string(worstFrame * 1000.0) + " ms" +
+               " over " + std::to_string(FRAME_BUDGET * 1000.0) + " ms: " + std::to_string(overBudget) +
+               " loaded " + std::to_string(stats.loaded) + " evicted " + std::to_string(stats.evicted) +
+               " resident " + std::to_string(stats.residentChunks) + " (most " + std::to_string(mostResident) + ", budget " + std::to_string(streamer.GetBudget()) + ")" +
+               " vertices " + std::to_string(stats.vertexBytes / 1024) + " KB" +
+               " latency avg " + std::to_string(stats.averageLatency * 1000.0) + " ms worst " + std::to_string(stats.worstLatency * 1000.0) + " ms");
+
+    bool passed = true;
+    if (overBudget * 100 > (int)frameSeconds.size())
+    {
+        Canis::Error("Streaming went over " + std::to_string(FRAME_BUDGET * 1000.0) + " ms in " + std::to_string(overBudget) + " frames");
+        passed = false;
+    }
+    if (!settled || missing > 0)
+    {
+        Canis::Error("Streaming left " + std::to_string(stats.pendingChunks) + " chunks pending and " + std::to_string(missing) + " missing around the camera");
+        passed = false;
+    }
+    if (mostResident > streamer.GetBudget() || uploaded.size() != stats.meshedChunks)
+    {
+        Canis::Error("Streaming kept " + std::to_string(mostResident) + " chunks over a budget of " + std::to_string(streamer.GetBudget()) +
+                     " with " + std::to_string(uploaded.size()) + " uploaded for " + std::to_string(stats.meshedChunks) + " meshed");
+        passed = false;
+    }
+
+    return passed;
+}
+
+// SparseVoxelGrid against the dense VoxelGrid on the shipped maps and a generated 512x256x512 world
+// memory, random point queries, walking the bricks and raycasts, every block has to match the dense grid
+bool BenchmarkSparseVoxels()
+{
+    Canis::TerrainSettings settings;
+    settings.seed = 1;
+
+    const char *mapNames[3] = {"assets/maps/level.map", "assets/maps/level1.map", "terrain 512x256x512"};
+    const int QUERIES = 1 << 22;
+    const int RAYS = 100000;
+    bool passed = true;
+
+    for (int m = 0; m < 3; m++)
+    {
+        if (m < 2)
+        {
+            if (!Canis::LoadMap(mapNames[m], map))
+                continue;
+        }
+        else
+        {
+            Canis::ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+            map.Resize(512, 256, 512);
+            Canis::GenerateTerrain(settings, map, pool);
+        }
+
+        Canis::SparseVoxelGrid sparse;
+        auto start = std::chrono::high_resolution_clock::now();
+        sparse.Build(map);
+        double buildSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        size_t mismatches = 0;
+        size_t solid = 0;
+        for (int y = 0; y < map.GetSizeY(); y++)
+            for (int x = 0; x < map.GetSizeX(); x++)
+                for (int z = 0; z < map.GetSizeZ(); z++)
+                {
+                    uint8_t block = map.Get(x, y, z);
+                    solid += (block != 0);
+                    mismatches += (sparse.Get(x, y, z) != block);
+                }
+
+        size_t brickSolid = 0;
+        sparse.ForEachBrick([&](glm::ivec3 _brick, const uint8_t *_blocks, uint8_t _id)
+        {
+            (void)_brick;
+            if (_blocks == nullptr)
+            {
+                brickSolid += (_id != 0) ? Canis::SparseVoxelGrid::BRICK_VOLUME : 0;
+                return;
+            }
+            for (int i = 0; i < Canis::SparseVoxelGrid::BRICK_VOLUME; i++)
+                brickSolid += (_blocks[i] != 0);
+        });
+
+        if (mismatches > 0 || brickSolid != solid)
+        {
+            Canis::Error(std::string(mapNames[m]) + " sparse grid has " + std::to_string(mismatches) + " wrong blocks and " +
+                         std::to_string(brickSolid) + " solid blocks in its bricks for " + std::to_string(solid));
+            passed = false;
+        }
+
+        // the same random positions for both, a little outside the grid so air is queried too
+        std::mt19937 random(1);
+        std::vector<glm::ivec3> positions(QUERIES);
+        for (glm::ivec3 &position : positions)
+            position = glm::ivec3(random() % (map.GetSizeX() + 16), random() % (map.GetSizeY() + 16), random() % (map.GetSizeZ() + 16)) - 8;
+
+        double querySeconds[2] = {};
+        size_t sums[2] = {};
+        for (int s = 0; s < 2; s++)
+        {
+            start = std::chrono::high_resolution_clock::now();
+            for (const glm::ivec3 &position : positions)
+                sums[s] += s ? sparse.Get(position.x, position.y, position.z) : map.Get(position.x, position.y, position.z);
+            querySeconds[s] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+
+        // rays from anywhere in the grid, every hit has to be solid and come through an air block
+        int hits = 0;
+        int badHits = 0;
+        glm::vec3 size = glm::vec3(map.GetSizeX(), map.GetSizeY(), map.GetSizeZ());
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        start = std::chrono::high_resolution_clock::now();
+        for (int r = 0; r < RAYS; r++)
+        {
+            glm::vec3 origin = glm::vec3(unit(random), unit(random), unit(random)) * size;
+            glm::vec3 direction = glm::vec3(unit(random), unit(random), unit(random)) * 2.0f - 1.0f;
+
+            Canis::VoxelHit hit;
+            if (!sparse.Raycast(origin, direction, 256.0f, hit))
+                continue;
+
+            hits++;
+            glm::ivec3 before = hit.block + hit.normal;
+            if (hit.id != map.Get(hit.block.x, hit.block.y, hit.block.z) || (hit.normal != glm::ivec3(0) && map.Get(before.x, before.y, before.z) != 0))
+                badHits++;
+        }
+        double raySeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        if (badHits > 0 || sums[0] != sums[1])
+        {
+            Canis::Error(std::string(mapNames[m]) + " sparse grid got " + std::to_string(badHits) + " wrong ray hits and the point queries sum to " +
+                         std::to_string(sums[1]) + " instead of " + std::to_string(sums[0]));
+            passed = false;
+        }
+
+        Canis::Log(std::string(mapNames[m]) + " dense: " + std::to_string(map.GetMemoryUsage() / 1024) + " KB sparse: " + std::to_string(sparse.GetMemoryUsage() / 1024) + " KB in " +
+                   std::to_string(sparse.GetBrickCount()) + " bricks (" + std::to_string(sparse.GetUniformBrickCount()) + " of one block) built in " + std::to_string(buildSeconds * 1000.0) + " ms");
+        Canis::Log(std::string(mapNames[m]) + " point queries dense: " + std::to_string(QUERIES / querySeconds[0] / 1000000.0) + " M/s sparse: " +
+                   std::to_string(QUERIES / querySeconds[1] / 1000000.0) + " M/s raycasts: " + std::to_string(RAYS / raySeconds / 1000000.0) + " M/s with " +
+                   std::to_string(hits) + " hits");
+    }
+
+    map.Clear();
+    return passed;
+}
+
+// PaletteChunk against the raw chunks of VoxelGrid on a generated 512x256x512 world
+// memory per chunk, random get and set, walking every block, and the blocks have to match the raw chunks after each
+bool BenchmarkPaletteChunks()
+{
+    Canis::TerrainSettings settings;
+    settings.seed = 1;
+
+    const int VOLUME = Canis::PaletteChunk::VOLUME;
+    const int OPERATIONS = 1 << 22;
+    bool passed = true;
+
+    {
+        Canis::ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        map.Resize(512, 256, 512);
+        Canis::GenerateTerrain(settings, map, pool);
+    }
+
+    glm::ivec3 chunkCount = map.GetChunkCount();
+    std::vector<uint8_t *> raw;
+    for (int cy = 0; cy < chunkCount.y; cy++)
+        for (int cx = 0; cx < chunkCount.x; cx++)
+            for (int cz = 0; cz < chunkCount.z; cz++)
+                raw.push_back(map.GetChunkData(glm::ivec3(cx, cy, cz)));
+
+    std::vector<Canis::PaletteChunk> chunks(raw.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t c = 0; c < chunks.size(); c++)
+        chunks[c].Encode(raw[c]);
+    double encodeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    // uniform, runs, then 1, 2, 4 and 8 bit indices
+    size_t kinds[6] = {};
+    auto memoryUsage = [&chunks]()
+    {
+        size_t bytes = 0;
+        for (const Canis::PaletteChunk &chunk : chunks)
+            bytes += chunk.GetMemoryUsage();
+        return bytes;
+    };
+
+    std::vector<uint8_t> decoded(VOLUME);
+    size_t mismatches = 0;
+    for (size_t c = 0; c < chunks.size(); c++)
+    {
+        int bits = chunks[c].GetBitsPerBlock();
+        kinds[(bits == 0) ? 0 : chunks[c].IsRunLength() ? 1 : (bits == 1) ? 2 : (bits == 2) ? 3 : (bits == 4) ? 4 : 5]++;
+
+        chunks[c].Decode(decoded.data());
+        mismatches += memcmp(decoded.data(), raw[c], VOLUME) != 0;
+    }
+
+    Canis::Log("Palette chunks: " + std::to_string(chunks.size()) + " chunks raw: " + std::to_string(VOLUME) + " bytes each (" + std::to_string(VOLUME * 4) +
+               " as 32 bit ids) palette: " + std::to_string(memoryUsage() / chunks.size()) + " bytes each, encoded in " + std::to_string(encodeSeconds * 1000.0) + " ms");
+    Canis::Log("Palette chunks: " + std::to_string(kinds[0]) + " of one block " + std::to_string(kinds[1]) + " runs " + std::to_string(kinds[2]) + " 1 bit " +
+               std::to_string(kinds[3]) + " 2 bit " + std::to_string(kinds[4]) + " 4 bit " + std::to_string(kinds[5]) + " 8 bit");
+
+    // the same random blocks for both
+    std::mt19937 random(1);
+    std::vector<uint32_t> chunkIndices(OPERATIONS);
+    std::vector<uint16_t> blockIndices(OPERATIONS);
+    for (int i = 0; i < OPERATIONS; i++)
+    {
+        chunkIndices[i] = random() % chunks.size();
+        blockIndices[i] = random() % VOLUME;
+    }
+
+    double getSeconds[2] = {};
+    size_t sums[2] = {};
+    for (int p = 0; p < 2; p++)
+    {
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < OPERATIONS; i++)
+            sums[p] += p ? chunks[chunkIndices[i]].Get(blockIndices[i]) : raw[chunkIndices[i]][blockIndices[i]];
+        getSeconds[p] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // every block once through Decode against copying the raw chunk
+    double walkSeconds[2] = {};
+    size_t walked[2] = {};
+    for (int p = 0; p < 2; p++)
+    {
+        start = std::chrono::high_resolution_clock::now();
+        for (size_t c = 0; c < chunks.size(); c++)
+        {
+            if (p)
+                chunks[c].Decode(decoded.data());
+            else
+                memcpy(decoded.data(), raw[c], VOLUME);
+            walked[p] += decoded[c % VOLUME];
+        }
+        walkSeconds[p] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    // digging and building with the blocks terrain uses and glass now and then, which grows some palettes
+    const uint8_t SET_BLOCKS[8] = {0, 0, 0, 2, 4, 5, 6, 1};
+    std::vector<uint8_t> setBlocks(OPERATIONS);
+    for (uint8_t &block : setBlocks)
+        block = SET_BLOCKS[random() % 8];
+
+    // the first pass grows the palettes and unpacks the runs, the second only writes indices
+    double setSeconds[3] = {};
+    for (int p = 0; p < 3; p++)
+    {
+        start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < OPERATIONS; i++)
+        {
+            if (p)
+                chunks[chunkIndices[i]].Set(blockIndices[i], setBlocks[i]);
+            else
+                raw[chunkIndices[i]][blockIndices[i]] = setBlocks[i];
+        }
+        setSeconds[p] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    size_t setMemory = memoryUsage();
+    for (Canis::PaletteChunk &chunk : chunks)
+        chunk.Compact();
+
+    for (size_t c = 0; c < chunks.size(); c++)
+    {
+        chunks[c].Decode(decoded.data());
+        mismatches += memcmp(decoded.data(), raw[c], VOLUME) != 0;
+    }
+
+    auto rate = [](double _seconds, double _count) { return std::to_string(_count / _seconds / 1000000.0); };
+    double blocks = (double)chunks.size() * VOLUME;
+
+    Canis::Log("Palette chunks get raw: " + rate(getSeconds[0], OPERATIONS) + " M/s palette: " + rate(getSeconds[1], OPERATIONS) + " M/s set raw: " +
+               rate(setSeconds[0], OPERATIONS) + " M/s palette: " + rate(setSeconds[1], OPERATIONS) + " M/s first and " + rate(setSeconds[2], OPERATIONS) + " M/s again");
+    Canis::Log("Palette chunks walk raw: " + rate(walkSeconds[0], blocks) + " M blocks/s palette: " + rate(walkSeconds[1], blocks) + " M blocks/s, after the sets " +
+               std::to_string(setMemory / chunks.size()) + " bytes each and " + std::to_string(memoryUsage() / chunks.size()) + " compacted");
+
+    if (mismatches > 0 || sums[0] != sums[1] || walked[0] != walked[1])
+    {
+        Canis::Error("Palette chunks differ from the raw chunks in " + std::to_string(mismatches) + " chunks");
+        passed = false;
+    }
+
+    map.Clear();
+    return passed;
+}
+
+// parse throughput of the fscanf parser and LoadOBJ on the shipped models and a generated 1M triangle grid
+void BenchmarkOBJ()
+{
+    std::string gridPath = (std::filesystem::temp_directory_path() / "canis_benchmark_grid.obj").string();
+    WriteBenchmarkGrid(gridPath);
+
+    const char *paths[4] = {"assets/models/cube.obj", "assets/models/plants.obj", "assets/models/fire.obj", gridPath.c_str()};
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int m = 0; m < 4; m++)
+    {
+        double megabytes = std::filesystem::file_size(paths[m]) / (1024.0 * 1024.0);
+        // small files are repeated until there is something to measure
+        int repeat = (m < 3) ? 2000 : 3;
+        double seconds[3] = {};
+        size_t vertexCount = 0;
+
+        for (int parser = 0; parser < 3; parser++)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int r = 0; r < repeat; r++)
+            {
+                std::vector<vec3> positions;
+                std::vector<vec2> uvs;
+                std::vector<vec3> normals;
+
+                if (parser == 0)
+                    Canis::LoadOBJScanf(paths[m], positions, uvs, normals);
+                else
+                    Canis::LoadOBJ(paths[m], positions, uvs, normals, (parser == 1) ? 1 : cores);
+
+                vertexCount = positions.size();
+            }
+            seconds[parser] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() / repeat;
+        }
+
+        Canis::Log(std::string((m < 3) ? paths[m] : "synthetic grid") + " vertices: " + std::to_string(vertexCount) +
+                   " fscanf: " + std::to_string(megabytes / seconds[0]) + " MB/s" +
+                   " LoadOBJ 1 thread: " + std::to_string(megabytes / seconds[1]) + " MB/s" +
+                   " LoadOBJ " + std::to_string(cores) + " threads: " + std::to_string(megabytes / seconds[2]) + " MB/s");
+    }
+
+    std::filesystem::remove(gridPath);
+}
+
+// vertex count and ACMR of the shipped models and a 1M triangle grid in random triangle order, before and after LoadModel's indexing
+void BenchmarkIndexing()
+{
+    std::vector<std::vector<float>> meshes;
+    const char *names[4] = {"assets/models/cube.obj", "assets/models/plants.obj", "assets/models/fire.obj", "shuffled grid"};
+
+    for (int m = 0; m < 3; m++)
+    {
+        std::vector<vec3> positions;
+        std::vector<vec2> uvs;
+        std::vector<vec3> normals;
+        Canis::LoadOBJ(names[m], positions, uvs, normals);
+
+        meshes.push_back({});
+        for (size_t i = 0; i < positions.size(); i++)
+        {
+            float vertex[8] = {positions[i].x, positions[i].y, positions[i].z, normals[i].x, normals[i].y, normals[i].z, uvs[i].x, uvs[i].y};
+            meshes.back().insert(meshes.back().end(), vertex, vertex + 8);
+        }
+    }
+
+    {
+        const int GRID = 708;
+        std::vector<ivec3> triangles;
+        for (int z = 0; z < GRID; z++)
+        {
+            for (int x = 0; x < GRID; x++)
+            {
+                int a = z * (GRID + 1) + x;
+                triangles.push_back(ivec3(a, a + GRID + 1, a + 1));
+                triangles.push_back(ivec3(a + 1, a + GRID + 1, a + GRID + 2));
+            }
+        }
+
+        std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1));
+
+        meshes.push_back({});
+        meshes.back().reserve(triangles.size() * 24);
+        for (ivec3 &triangle : triangles)
+        {
+            for (int corner = 0; corner < 3; corner++)
+            {
+                float x = triangle[corner] % (GRID + 1);
+                float z = triangle[corner] / (GRID + 1);
+                float vertex[8] = {x * 0.1f, 0.0f, z * -0.1f, 0.0f, 1.0f, 0.0f, x / GRID, z / GRID};
+                meshes.back().insert(meshes.back().end(), vertex, vertex + 8);
+            }
+        }
+    }
+
+    for (int m = 0; m < 4; m++)
+    {
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        Canis::BuildIndexedMesh(meshes[m], vertices, indices);
+        float indexedACMR = Canis::ComputeACMR(indices, vertices.size() / 8);
+        Canis::OptimizeVertexCache(indices, vertices.size() / 8);
+        Canis::OptimizeVertexFetch(vertices, indices);
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        // drawn with glDrawArrays every vertex is shaded, an ACMR of 3
+        Canis::Log(std::string(names[m]) + " vertices: " + std::to_string(meshes[m].size() / 8) + " -> " + std::to_string(vertices.size() / 8) +
+                   " ACMR: 3.0 -> " + std::to_string(indexedACMR) + " indexed -> " + std::to_string(Canis::ComputeACMR(indices, vertices.size() / 8)) +
+                   " optimized (" + std::to_string(seconds * 1000.0) + " ms)");
+    }
+}
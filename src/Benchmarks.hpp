@@ -0,0 +1,5 @@
+#pragma once
+
+// runs every benchmark when project.canis sets benchmark true, logging what each one measured
+// returns false when a benchmark that checks its results found a mismatch
+bool RunBenchmarks();
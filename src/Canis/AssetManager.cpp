@@ -0,0 +1,259 @@
+#include "AssetManager.hpp"
+#include "Debug.hpp"
+
+#include <GL/glew.h>
+
+namespace Canis
+{
+    namespace
+    {
+        std::string TextureKey(const std::string &_path, bool _wrap, int _sourceFormat, int _format)
+        {
+            return _path + "|" + (_wrap ? "wrap" : "clamp") + "|" + std::to_string(_sourceFormat) + "|" + std::to_string(_format);
+        }
+
+        // rgba8 with a full mip chain is about 4/3 of the base level
+        size_t TextureBytes(const GLTexture &_texture)
+        {
+            size_t layers = (_texture.layers > 0) ? _texture.layers : 1;
+            return (size_t)_texture.width * _texture.height * 4 * layers * 4 / 3;
+        }
+
+        size_t ModelBytes(const Model &_model)
+        {
+            return (size_t)_model.vertexCount * _model.vertexStride + (size_t)_model.indexCount * sizeof(uint32_t);
+        }
+    }
+
+    template <typename T>
+    AssetHandle<T> AssetManager::Find(AssetTable<T> &_table, const std::string &_key)
+    {
+        auto it = _table.ids.find(_key);
+        if (it == _table.ids.end())
+            return AssetHandle<T>();
+
+        AssetEntry<T> &entry = _table[it->second - 1];
+        entry.references++;
+        m_stats.hits++;
+        return AssetHandle<T>{it->second, entry.generation};
+    }
+
+    template <typename T>
+    AssetHandle<T> AssetManager::Add(AssetTable<T> &_table, const std::string &_key, const T &_asset, size_t _bytes)
+    {
+        unsigned int id;
+
+        // released slots are reused so the deque only grows with the number of live assets
+        if (!_table.freeIds.empty())
+        {
+            id = _table.freeIds.back();
+            _table.freeIds.pop_back();
+        }
+        else
+        {
+            _table.entries.emplace_back();
+            id = _table.entries.size();
+        }
+
+        AssetEntry<T> &entry = _table[id - 1];
+        entry.generation++;
+        entry.key = _key;
+        entry.asset = _asset;
+        entry.references = 1;
+        entry.bytes = _bytes;
+
+        _table.ids[_key] = id;
+        m_stats.misses++;
+        return AssetHandle<T>{id, entry.generation};
+    }
+
+    template <typename T>
+    bool AssetManager::Unreference(AssetTable<T> &_table, AssetHandle<T> _handle, const char *_type)
+    {
+        if (!_handle.IsValid() || _handle.id > _table.entries.size() ||
+            _table[_handle.id - 1].references == 0 || _table[_handle.id - 1].generation != _handle.generation)
+        {
+            Warning(std::string("Released a ") + _type + " that is not loaded");
+            return false;
+        }
+
+        AssetEntry<T> &entry = _table[_handle.id - 1];
+        if (--entry.references > 0)
+            return false;
+
+        _table.ids.erase(entry.key);
+        _table.freeIds.push_back(_handle.id);
+        m_stats.released++;
+        return true;
+    }
+
+    TextureHandle AssetManager::AddTexture(const std::string &_key, const GLTexture &_texture)
+    {
+        size_t bytes = TextureBytes(_texture);
+        m_stats.textures++;
+        m_stats.textureBytes += bytes;
+        return Add(m_textures, _key, _texture, bytes);
+    }
+
+    TextureHandle AssetManager::LoadTexture(const std::string &_path, bool _wrap)
+    {
+        return LoadTextures({{_path, _wrap}})[0];
+    }
+
+    std::vector<TextureHandle> AssetManager::LoadTextures(const std::vector<TextureRequest> &_requests)
+    {
+        std::vector<TextureHandle> handles(_requests.size());
+        std::vector<std::string> keys(_requests.size());
+        std::vector<TextureRequest> missing;
+        std::vector<size_t> missingIndices;
+        std::unordered_map<std::string, size_t> pending;
+
+        for (size_t i = 0; i < _requests.size(); i++)
+        {
+            const TextureRequest &request = _requests[i];
+            keys[i] = TextureKey(request.path, request.wrap, request.sourceFormat, request.format);
+            handles[i] = Find(m_textures, keys[i]);
+
+            // the same texture twice in one batch is decoded once, the second is a hit below
+            if (!handles[i].IsValid() && pending.insert({keys[i], i}).second)
+            {
+                missing.push_back(request);
+                missingIndices.push_back(i);
+            }
+        }
+
+        std::vector<GLTexture> textures = LoadImagesGL(missing);
+
+        for (size_t m = 0; m < missing.size(); m++)
+            handles[missingIndices[m]] = AddTexture(keys[missingIndices[m]], textures[m]);
+
+        for (size_t i = 0; i < _requests.size(); i++)
+            if (!handles[i].IsValid())
+                handles[i] = Find(m_textures, keys[i]);
+
+        return handles;
+    }
+
+    TextureHandle AssetManager::LoadTextureArray(const std::vector<std::string> &_paths, bool _wrap)
+    {
+        std::string key = "array|" + std::string(_wrap ? "wrap" : "clamp");
+        for (const std::string &path : _paths)
+            key += "|" + path;
+
+        TextureHandle handle = Find(m_textures, key);
+        if (handle.IsValid())
+            return handle;
+
+        return AddTexture(key, LoadImageArrayGL(_paths, _wrap));
+    }
+
+    ModelHandle AssetManager::LoadModel(const std::string &_path)
+    {
+        ModelHandle handle = Find(m_models, _path);
+        if (handle.IsValid())
+            return handle;
+
+        Model model = Canis::LoadModel(_path);
+        size_t bytes = ModelBytes(model);
+
+        m_stats.models++;
+        m_stats.modelBytes += bytes;
+        return Add(m_models, _path, model, bytes);
+    }
+
+    ShaderHandle AssetManager::LoadShader(const std::string &_vertexPath, const std::string &_fragmentPath,
+                                          const std::vector<std::string> &_attributes, const std::vector<std::string> &_defines)
+    {
+        std::string key = _vertexPath + "|" + _fragmentPath;
+        for (const std::string &define : _defines)
+            key += "|" + define;
+
+        ShaderHandle handle = Find(m_shaders, key);
+        if (handle.IsValid())
+            return handle;
+
+        // the shader is built in its slot, Shader is not meant to be copied once compiled
+        handle = Add(m_shaders, key, Shader(), 0);
+        Shader &shader = Get(handle);
+
+        for (const std::string &define : _defines)
+            shader.AddDefine(define);
+
+        shader.Compile(_vertexPath, _fragmentPath);
+        for (const std::string &attribute : _attributes)
+            shader.AddAttribute(attribute);
+        shader.Link();
+
+        m_stats.shaders++;
+        return handle;
+    }
+
+    void AssetManager::Release(TextureHandle _handle)
+    {
+        if (!Unreference(m_textures, _handle, "texture"))
+            return;
+
+        AssetEntry<GLTexture> &entry = m_textures[_handle.id - 1];
+        glDeleteTextures(1, &entry.asset.id);
+
+        m_stats.textures--;
+        m_stats.textureBytes -= entry.bytes;
+        unsigned int generation = entry.generation;
+        entry = AssetEntry<GLTexture>();
+        entry.generation = generation;
+    }
+
+    void AssetManager::Release(ModelHandle _handle)
+    {
+        if (!Unreference(m_models, _handle, "model"))
+            return;
+
+        AssetEntry<Model> &entry = m_models[_handle.id - 1];
+        UnloadModel(entry.asset);
+
+        m_stats.models--;
+        m_stats.modelBytes -= entry.bytes;
+        unsigned int generation = entry.generation;
+        entry = AssetEntry<Model>();
+        entry.generation = generation;
+    }
+
+    void AssetManager::Release(ShaderHandle _handle)
+    {
+        if (!Unreference(m_shaders, _handle, "shader"))
+            return;
+
+        AssetEntry<Shader> &entry = m_shaders[_handle.id - 1];
+        glDeleteProgram(entry.asset.GetProgramID());
+
+        m_stats.shaders--;
+        unsigned int generation = entry.generation;
+        entry = AssetEntry<Shader>();
+        entry.generation = generation;
+    }
+
+    void AssetManager::LogAssets() const
+    {
+        Log("Assets: " + std::to_string(m_stats.hits) + " hits " + std::to_string(m_stats.misses) + " misses " +
+            std::to_string(m_stats.released) + " released " +
+            std::to_string((m_stats.textureBytes + m_stats.modelBytes) / 1024) + " KB");
+
+        for (const AssetEntry<GLTexture> &entry : m_textures.entries)
+            if (entry.references > 0)
+                Log("  texture " + entry.key + " refs " + std::to_string(entry.references) + " KB " + std::to_string(entry.bytes / 1024));
+
+        for (const AssetEntry<Model> &entry : m_models.entries)
+            if (entry.references > 0)
+                Log("  model " + entry.key + " refs " + std::to_string(entry.references) + " KB " + std::to_string(entry.bytes / 1024));
+
+        for (const AssetEntry<Shader> &entry : m_shaders.entries)
+            if (entry.references > 0)
+                Log("  shader " + entry.key + " refs " + std::to_string(entry.references));
+    }
+
+    AssetManager &GetAssetManager()
+    {
+        static AssetManager assetManager;
+        return assetManager;
+    }
+} // end of Canis namespace
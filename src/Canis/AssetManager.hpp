@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Data/GLTexture.hpp"
+#include "IOManager.hpp"
+#include "Model.hpp"
+#include "Shader.hpp"
+
+namespace Canis
+{
+    // index + 1 into the assets of one type, 0 is never a loaded asset
+    // the generation changes when a released slot is reused so old handles are caught like EntityHandle
+    template <typename T>
+    struct AssetHandle
+    {
+        unsigned int id = 0;
+        unsigned int generation = 0;
+
+        bool IsValid() const { return id != 0; }
+    };
+
+    typedef AssetHandle<GLTexture> TextureHandle;
+    typedef AssetHandle<Model> ModelHandle;
+    typedef AssetHandle<Shader> ShaderHandle;
+
+    struct AssetStats
+    {
+        unsigned int hits = 0;     // loads answered by an asset that was already loaded
+        unsigned int misses = 0;   // loads that read files and created gl objects
+        unsigned int released = 0; // assets freed after their last reference was released
+        unsigned int textures = 0;
+        unsigned int models = 0;
+        unsigned int shaders = 0;
+        size_t textureBytes = 0; // estimated gpu memory, mipmaps included
+        size_t modelBytes = 0;
+    };
+
+    // loads every texture, model and shader once per path and parameters
+    // each Load counts as one reference and needs one Release, the gl objects are freed with the last one
+    class AssetManager
+    {
+    public:
+        TextureHandle LoadTexture(const std::string &_path, bool _wrap);
+        // textures not loaded yet are decoded together on the thread pool like LoadImagesGL
+        std::vector<TextureHandle> LoadTextures(const std::vector<TextureRequest> &_requests);
+        TextureHandle LoadTextureArray(const std::vector<std::string> &_paths, bool _wrap);
+        ModelHandle LoadModel(const std::string &_path);
+        // _attributes are bound in order before linking, shaders with other _defines are separate programs
+        ShaderHandle LoadShader(const std::string &_vertexPath, const std::string &_fragmentPath,
+                                const std::vector<std::string> &_attributes, const std::vector<std::string> &_defines = {});
+
+        // references stay valid until the last Release of the handle
+        GLTexture &Get(TextureHandle _handle) { return m_textures[_handle.id - 1].asset; }
+        Model &Get(ModelHandle _handle) { return m_models[_handle.id - 1].asset; }
+        Shader &Get(ShaderHandle _handle) { return m_shaders[_handle.id - 1].asset; }
+
+        void Release(TextureHandle _handle);
+        void Release(ModelHandle _handle);
+        void Release(ShaderHandle _handle);
+
+        const AssetStats &GetStats() const { return m_stats; }
+        // one line per loaded asset with its references and gpu bytes
+        void LogAssets() const;
+
+    private:
+        template <typename T>
+        struct AssetEntry
+        {
+            std::string key = "";
+            T asset = {};
+            unsigned int references = 0;
+            unsigned int generation = 0;
+            size_t bytes = 0;
+        };
+
+        template <typename T>
+        struct AssetTable
+        {
+            std::deque<AssetEntry<T>> entries = {};
+            std::unordered_map<std::string, unsigned int> ids = {};
+            std::vector<unsigned int> freeIds = {};
+
+            AssetEntry<T> &operator[](unsigned int _index) { return entries[_index]; }
+        };
+
+        AssetTable<GLTexture> m_textures;
+        AssetTable<Model> m_models;
+        AssetTable<Shader> m_shaders;
+        AssetStats m_stats;
+
+        template <typename T>
+        AssetHandle<T> Find(AssetTable<T> &_table, const std::string &_key);
+        template <typename T>
+        AssetHandle<T> Add(AssetTable<T> &_table, const std::string &_key, const T &_asset, size_t _bytes);
+        template <typename T>
+        bool Unreference(AssetTable<T> &_table, AssetHandle<T> _handle, const char *_type);
+
+        TextureHandle AddTexture(const std::string &_key, const GLTexture &_texture);
+    };
+
+    // shared by the engine and the game, created on first use
+    // gl objects still referenced at exit are left to the context
+    extern AssetManager &GetAssetManager();
+} // end of Canis namespace
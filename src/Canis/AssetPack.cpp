@@ -0,0 +1,292 @@
+#include "AssetPack.hpp"
+#include "Debug.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+namespace Canis
+{
+    namespace
+    {
+        const char PACK_MAGIC[4] = {'C', 'P', 'A', 'K'};
+
+        // the mounted pack, written once at startup
+        MappedFile packFile;
+        const AssetPackHeader *packHeader = nullptr;
+        const AssetPackEntry *packTable = nullptr;
+
+        // the loaders build paths by hand, so windows separators and a leading ./ are folded away
+        std::string NormalizePath(const std::string &_path)
+        {
+            std::string path = _path;
+            std::replace(path.begin(), path.end(), '\\', '/');
+
+            while (path.compare(0, 2, "./") == 0)
+                path.erase(0, 2);
+
+            return path;
+        }
+
+        uint64_t HashPath(const std::string &_path)
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (char c : _path)
+            {
+                hash ^= (uint8_t)c;
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        bool GetLooseFileStamp(const std::string &_path, uint64_t &_size, int64_t &_time)
+        {
+            std::error_code error;
+            _size = std::filesystem::file_size(_path, error);
+            if (error)
+                return false;
+
+            _time = std::filesystem::last_write_time(_path, error).time_since_epoch().count();
+            return !error;
+        }
+
+        const AssetPackEntry *FindEntry(const std::string &_path)
+        {
+            if (packHeader == nullptr)
+                return nullptr;
+
+            std::string path = NormalizePath(_path);
+            uint64_t hash = HashPath(path);
+            uint32_t mask = packHeader->tableSize - 1;
+
+            for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask)
+            {
+                const AssetPackEntry &entry = packTable[slot];
+
+                if (entry.nameLength == 0)
+                    return nullptr;
+
+                if (entry.hash == hash && entry.nameLength == path.size() &&
+                    memcmp(packFile.GetData() + entry.nameOffset, path.data(), path.size()) == 0)
+                    return &entry;
+            }
+        }
+
+        // the entry unless a loose file at the same path was edited after packing
+        const AssetPackEntry *FindCurrentEntry(const std::string &_path)
+        {
+            const AssetPackEntry *entry = FindEntry(_path);
+            if (entry == nullptr)
+                return nullptr;
+
+            uint64_t size = 0;
+            int64_t time = 0;
+            if (GetLooseFileStamp(_path, size, time) && (size != entry->size || time != entry->sourceTime))
+                return nullptr;
+
+            return entry;
+        }
+
+        bool ValidatePack()
+        {
+            size_t size = packFile.GetSize();
+            const AssetPackHeader *header = (const AssetPackHeader *)packFile.GetData();
+
+            if (size < sizeof(AssetPackHeader) || memcmp(header->magic, PACK_MAGIC, 4) != 0 || header->version != ASSET_PACK_VERSION)
+                return false;
+
+            // a full table would never end a failed lookup
+            if (header->tableSize == 0 || (header->tableSize & (header->tableSize - 1)) != 0 || header->entryCount >= header->tableSize)
+                return false;
+
+            if (header->tableOffset + (uint64_t)header->tableSize * sizeof(AssetPackEntry) > size)
+                return false;
+
+            const AssetPackEntry *table = (const AssetPackEntry *)(packFile.GetData() + header->tableOffset);
+            for (uint32_t i = 0; i < header->tableSize; i++)
+                if (table[i].offset + table[i].size > size || table[i].nameOffset + table[i].nameLength > size)
+                    return false;
+
+            return true;
+        }
+    }
+
+    bool VirtualFile::Open(const std::string &_path)
+    {
+        Close();
+
+        const AssetPackEntry *entry = FindCurrentEntry(_path);
+        if (entry != nullptr)
+        {
+            m_data = (entry->size > 0) ? packFile.GetData() + entry->offset : nullptr;
+            m_size = entry->size;
+            m_open = true;
+            m_packed = true;
+            return true;
+        }
+
+        if (!m_file.Open(_path))
+            return false;
+
+        m_data = m_file.GetData();
+        m_size = m_file.GetSize();
+        m_open = true;
+        return true;
+    }
+
+    void VirtualFile::Close()
+    {
+        m_file.Close();
+        m_data = nullptr;
+        m_size = 0;
+        m_open = false;
+        m_packed = false;
+    }
+
+    bool MountAssetPack(const std::string &_packPath)
+    {
+        UnmountAssetPack();
+
+        if (!packFile.Open(_packPath))
+            return false;
+
+        if (!ValidatePack())
+        {
+            Warning("Asset pack " + _packPath + " is not a valid pack, loading loose files");
+            packFile.Close();
+            return false;
+        }
+
+        packHeader = (const AssetPackHeader *)packFile.GetData();
+        packTable = (const AssetPackEntry *)(packFile.GetData() + packHeader->tableOffset);
+        Log("Mounted asset pack " + _packPath + " with " + std::to_string(packHeader->entryCount) + " files");
+        return true;
+    }
+
+    void UnmountAssetPack()
+    {
+        packHeader = nullptr;
+        packTable = nullptr;
+        packFile.Close();
+    }
+
+    bool IsAssetPackMounted()
+    {
+        return packHeader != nullptr;
+    }
+
+    bool GetFileStamp(const std::string &_path, uint64_t &_size, int64_t &_time)
+    {
+        const AssetPackEntry *entry = FindCurrentEntry(_path);
+        if (entry != nullptr)
+        {
+            _size = entry->size;
+            _time = entry->sourceTime;
+            return true;
+        }
+
+        return GetLooseFileStamp(_path, _size, _time);
+    }
+
+    bool BuildAssetPack(const std::string &_directory, const std::string &_packPath)
+    {
+        std::error_code error;
+        std::vector<std::string> paths;
+
+        for (const auto &file : std::filesystem::recursive_directory_iterator(_directory, error))
+        {
+            if (!file.is_regular_file())
+                continue;
+
+            std::error_code ignored;
+            if (file.path().extension().string().compare(0, 4, ".tmp") == 0 || std::filesystem::equivalent(file.path(), _packPath, ignored))
+                continue;
+
+            paths.push_back(NormalizePath(file.path().generic_string()));
+        }
+
+        if (error)
+        {
+            Error("Can not read " + _directory + " to build the asset pack");
+            return false;
+        }
+
+        // sorted so the same tree always gives the same pack
+        std::sort(paths.begin(), paths.end());
+
+        AssetPackHeader header = {};
+        memcpy(header.magic, PACK_MAGIC, 4);
+        header.version = ASSET_PACK_VERSION;
+        header.entryCount = paths.size();
+        header.tableSize = 16;
+        while (header.tableSize < paths.size() * 2)
+            header.tableSize *= 2;
+        header.tableOffset = AlignBlob(sizeof(AssetPackHeader));
+
+        // names right after the table, then every file on a 16 byte boundary like the caches expect
+        std::vector<AssetPackEntry> table(header.tableSize);
+        std::vector<AssetPackEntry> entries(paths.size());
+        uint64_t offset = header.tableOffset + (uint64_t)header.tableSize * sizeof(AssetPackEntry);
+
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            entries[i].hash = HashPath(paths[i]);
+            entries[i].nameOffset = offset;
+            entries[i].nameLength = paths[i].size();
+            offset += paths[i].size();
+        }
+
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            // a mounted pack is not consulted, the new one is built from what is on disk
+            if (!GetLooseFileStamp(paths[i], entries[i].size, entries[i].sourceTime))
+            {
+                Error("Can not read " + paths[i] + " to build the asset pack");
+                return false;
+            }
+
+            offset = AlignBlob(offset);
+            entries[i].offset = offset;
+            offset += entries[i].size;
+
+            uint32_t slot = entries[i].hash & (header.tableSize - 1);
+            while (table[slot].nameLength != 0)
+                slot = (slot + 1) & (header.tableSize - 1);
+            table[slot] = entries[i];
+        }
+
+        auto write = [&](std::ostream &_file)
+        {
+            _file.write((const char *)&header, sizeof(header));
+            WritePadding(_file, header.tableOffset);
+            _file.write((const char *)table.data(), table.size() * sizeof(AssetPackEntry));
+
+            for (const std::string &path : paths)
+                _file.write(path.data(), path.size());
+
+            for (size_t i = 0; i < paths.size() && _file.good(); i++)
+            {
+                MappedFile source;
+                if (!source.Open(paths[i]) || source.GetSize() != entries[i].size)
+                {
+                    Error("Can not read " + paths[i] + " to build the asset pack");
+                    _file.setstate(std::ios::failbit);
+                    break;
+                }
+
+                WritePadding(_file, entries[i].offset);
+                _file.write(source.GetData(), source.GetSize());
+            }
+        };
+
+        if (!WriteFileAtomically(_packPath, write))
+        {
+            Error("Can not write asset pack " + _packPath);
+            return false;
+        }
+
+        Log("Packed " + std::to_string(paths.size()) + " files into " + _packPath + " (" + std::to_string(offset / 1024) + " KB)");
+        return true;
+    }
+} // end of Canis namespace
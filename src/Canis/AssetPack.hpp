@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "MappedFile.hpp"
+
+namespace Canis
+{
+    // bump when the layout changes, older packs are not mounted and the loose files are used
+    const uint32_t ASSET_PACK_VERSION = 1;
+
+    // start of a pack, the hash table of entries follows at tableOffset
+    struct AssetPackHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t tableSize; // power of two, at most half of the slots are used
+        uint64_t tableOffset;
+    };
+
+    // one slot of the table, an empty slot has nameLength 0
+    struct AssetPackEntry
+    {
+        uint64_t hash; // FNV-1a of the path
+        uint64_t offset;
+        uint64_t size;
+        int64_t sourceTime; // write time of the loose file when it was packed
+        uint64_t nameOffset;
+        uint64_t nameLength;
+    };
+
+    // read only view of a file in the mounted pack or of a loose file, used like MappedFile
+    class VirtualFile
+    {
+    public:
+        VirtualFile() {}
+
+        VirtualFile(const VirtualFile &) = delete;
+        VirtualFile &operator=(const VirtualFile &) = delete;
+
+        // looks in the mounted pack first, a loose file at the same path wins when its size or write time
+        // differs from when it was packed so edits show up without running --pack again
+        bool Open(const std::string &_path);
+        void Close();
+
+        bool IsOpen() const { return m_open; }
+        bool IsPacked() const { return m_packed; }
+        const char *GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+    private:
+        MappedFile m_file;
+        const char *m_data = nullptr;
+        size_t m_size = 0;
+        bool m_open = false;
+        bool m_packed = false;
+    };
+
+    // maps the pack for the rest of the run, false when it is missing or not a valid pack
+    // mount before loading starts, VirtualFile reads the table from any thread without locking
+    extern bool MountAssetPack(const std::string &_packPath);
+    extern void UnmountAssetPack();
+    extern bool IsAssetPackMounted();
+
+    // size and write time the caches compare against, taken from the table for packed files
+    extern bool GetFileStamp(const std::string &_path, uint64_t &_size, int64_t &_time);
+
+    // packs every file under _directory by the path the loaders use, like assets/textures/grass.png
+    // existing .cmesh and .ctex files are packed too so a shipped pack needs no cooking, their temporary files are not
+    extern bool BuildAssetPack(const std::string &_directory, const std::string &_packPath);
+} // end of Canis namespace
@@ -0,0 +1,64 @@
+#include "BlockRegistry.hpp"
+#include "Debug.hpp"
+
+namespace Canis
+{
+    void BlockRegistry::Register(uint8_t _id, const std::string &_tag, bool _transparent,
+                                 const std::string &_side, const std::string &_top, const std::string &_bottom)
+    {
+        if (_id == 0)
+        {
+            Warning("Block id 0 is air and can not be registered");
+            return;
+        }
+
+        BlockInfo &info = m_blockInfo[_id];
+        info.cube = true;
+        info.transparent = _transparent;
+
+        float side = GetLayer(_side);
+        float top = _top.empty() ? side : GetLayer(_top);
+        float bottom = _bottom.empty() ? side : GetLayer(_bottom);
+
+        // same order as the faces of ChunkMesher, +x, -x, +y, -y, +z, -z
+        info.layers[0] = side;
+        info.layers[1] = side;
+        info.layers[2] = top;
+        info.layers[3] = bottom;
+        info.layers[4] = side;
+        info.layers[5] = side;
+
+        m_tags[_id] = _tag;
+    }
+
+    void BlockRegistry::LoadTextures()
+    {
+        if (m_layerPaths.empty())
+        {
+            Warning("No block textures to load");
+            return;
+        }
+
+        // chunk uvs run past 1 on greedy quads so the layers have to repeat
+        m_textureArray = GetAssetManager().LoadTextureArray(m_layerPaths, true);
+    }
+
+    void BlockRegistry::ReleaseTextures()
+    {
+        if (!m_textureArray.IsValid())
+            return;
+
+        GetAssetManager().Release(m_textureArray);
+        m_textureArray = TextureHandle();
+    }
+
+    float BlockRegistry::GetLayer(const std::string &_path)
+    {
+        for (size_t i = 0; i < m_layerPaths.size(); i++)
+            if (m_layerPaths[i] == _path)
+                return i;
+
+        m_layerPaths.push_back(_path);
+        return m_layerPaths.size() - 1;
+    }
+} // end of Canis namespace
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "ChunkMesher.hpp"
+#include "AssetManager.hpp"
+
+namespace Canis
+{
+    // the cube blocks of a map, every face texture of every block is one layer of a single texture array
+    // so chunks holding any mix of blocks draw with one texture and one program
+    class BlockRegistry
+    {
+    public:
+        // _top and _bottom fall back to _side, a path used by several blocks is stored once
+        void Register(uint8_t _id, const std::string &_tag, bool _transparent,
+                      const std::string &_side, const std::string &_top = "", const std::string &_bottom = "");
+
+        // needs a gl context, call once every block is registered
+        void LoadTextures();
+        void ReleaseTextures();
+
+        const BlockInfo *GetBlockInfo() const { return m_blockInfo; }
+        const std::string &GetTag(uint8_t _id) const { return m_tags[_id]; }
+        GLTexture &GetTextureArray() { return GetAssetManager().Get(m_textureArray); }
+        unsigned int GetLayerCount() const { return m_layerPaths.size(); }
+        const std::vector<std::string> &GetLayerPaths() const { return m_layerPaths; }
+
+    private:
+        float GetLayer(const std::string &_path);
+
+        BlockInfo m_blockInfo[MAX_BLOCK_TYPES] = {};
+        std::string m_tags[MAX_BLOCK_TYPES] = {};
+        std::vector<std::string> m_layerPaths = {};
+        TextureHandle m_textureArray = {};
+    };
+} // end of Canis namespace
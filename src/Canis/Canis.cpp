@@ -1,5 +1,6 @@
 #include "Canis.hpp"
 #include "Debug.hpp"
+#include "AssetPack.hpp"
 #include <SDL.h>
 
 #include <fstream>
@@ -97,9 +98,69 @@ namespace Canis
                     continue;
                 }
             }
+            if (word == "greedy_meshing")
+            {
+                if (file >> word)
+                {
+                    GetConfig().greedyMeshing = (word == "true");
+                    continue;
+                }
+            }
+            if (word == "mesh_cache")
+            {
+                if (file >> word)
+                {
+                    GetConfig().meshCache = (word == "true");
+                    continue;
+                }
+            }
+            if (word == "texture_cache")
+            {
+                if (file >> word)
+                {
+                    GetConfig().textureCache = (word == "true");
+                    continue;
+                }
+            }
+            if (word == "asset_pack")
+            {
+                if (file >> word)
+                {
+                    GetConfig().assetPack = (word == "none") ? "" : word;
+                    continue;
+                }
+            }
+            if (word == "stream_radius")
+            {
+                if (file >> wholeNumber)
+                {
+                    GetConfig().streamRadius = wholeNumber;
+                    continue;
+                }
+            }
+            if (word == "stream_budget")
+            {
+                if (file >> wholeNumber)
+                {
+                    GetConfig().streamBudget = wholeNumber;
+                    continue;
+                }
+            }
+            if (word == "benchmark")
+            {
+                if (file >> word)
+                {
+                    GetConfig().benchmark = (word == "true");
+                    continue;
+                }
+            }
         }
 
         file.close();
+
+        // project.canis itself stays a loose file since it names the pack
+        if (!GetConfig().assetPack.empty() && !MountAssetPack(GetConfig().assetPack))
+            Log("No asset pack at " + GetConfig().assetPack + ", loading loose files");
         
         return 0;
     }
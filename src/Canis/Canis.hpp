@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 
 namespace Canis
 {
@@ -14,6 +15,13 @@ namespace Canis
         float volume = 1.0f;
         bool mute = false;
         bool log = false;
+        bool greedyMeshing = true;
+        bool meshCache = true; // LoadModel reads and writes binary .cmesh copies of the obj files
+        bool textureCache = true; // images are loaded from .ctex copies holding their mip chain
+        std::string assetPack = "assets.cpak"; // files in the pack are read from it, the rest from assets/, none turns it off
+        int streamRadius = 8; // chunks around the camera that are meshed and drawn
+        int streamBudget = 4096; // chunks kept meshed before the ones left behind longest ago are evicted
+        bool benchmark = false; // runs the benchmarks and exits without opening a window
     };
 
     ProjectConfig& GetConfig();
@@ -0,0 +1,159 @@
+#include "ChunkMesher.hpp"
+
+namespace Canis
+{
+    namespace
+    {
+        // a face looks along its normal axis, u runs left to right and v bottom to top
+        // when looking at the face from outside like cube.obj
+        struct FaceDefinition
+        {
+            int normalAxis, normalSign;
+            int uAxis, uSign;
+            int vAxis, vSign;
+        };
+
+        const FaceDefinition FACES[6] = {
+            {0, 1, 2, -1, 1, 1},  // +x
+            {0, -1, 2, 1, 1, 1},  // -x
+            {1, 1, 0, 1, 2, -1},  // +y
+            {1, -1, 0, 1, 2, 1},  // -y
+            {2, 1, 0, 1, 1, 1},   // +z
+            {2, -1, 0, -1, 1, 1}, // -z
+        };
+
+        const int CORNERS[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+
+        // two triangles per quad, counter clockwise seen from outside
+        const int QUAD_CORNERS[6] = {0, 1, 2, 0, 2, 3};
+
+        bool IsFaceVisible(uint8_t _block, uint8_t _neighbour, const BlockInfo *_blockInfo)
+        {
+            if (_neighbour == 0)
+                return true;
+
+            const BlockInfo &neighbour = _blockInfo[_neighbour];
+
+            // plants and fire do not hide anything
+            if (!neighbour.cube)
+                return true;
+
+            // glass next to glass hides the shared face
+            if (neighbour.transparent)
+                return _neighbour != _block;
+
+            return false;
+        }
+
+        // emits a quad covering blocks [_u, _u + _width) x [_v, _v + _height) of the slice, uvs tile once per block
+        void EmitQuad(std::vector<float> &_vertices, const FaceDefinition &_face, float _layer, int _slice, int _u, int _v, int _width, int _height)
+        {
+            for (int i = 0; i < 6; i++)
+            {
+                const int *corner = CORNERS[QUAD_CORNERS[i]];
+                float position[3];
+
+                position[_face.normalAxis] = _slice + 0.5f * _face.normalSign;
+
+                // a negative axis starts from the far side of the rectangle
+                float uStart = (_face.uSign > 0) ? _u - 0.5f : _u + _width - 0.5f;
+                float vStart = (_face.vSign > 0) ? _v - 0.5f : _v + _height - 0.5f;
+                position[_face.uAxis] = uStart + _face.uSign * corner[0] * _width;
+                position[_face.vAxis] = vStart + _face.vSign * corner[1] * _height;
+
+                _vertices.push_back(position[0]);
+                _vertices.push_back(position[1]);
+                _vertices.push_back(position[2]);
+                _vertices.push_back(_face.normalAxis == 0 ? (float)_face.normalSign : 0.0f);
+                _vertices.push_back(_face.normalAxis == 1 ? (float)_face.normalSign : 0.0f);
+                _vertices.push_back(_face.normalAxis == 2 ? (float)_face.normalSign : 0.0f);
+                // LoadOBJ stores -v and the shaders flip it back
+                _vertices.push_back((float)(corner[0] * _width));
+                _vertices.push_back(-(float)(corner[1] * _height));
+                _vertices.push_back(_layer);
+            }
+        }
+    }
+
+    void BuildChunkMesh(const uint8_t *_paddedBlocks, const BlockInfo *_blockInfo, std::vector<float> &_vertices, MeshingMode _mode)
+    {
+        _vertices.clear();
+
+        // block id of every visible face in the current slice, 0 when there is no face
+        uint8_t mask[CHUNK_SIZE][CHUNK_SIZE];
+
+        for (int f = 0; f < 6; f++)
+        {
+            const FaceDefinition &face = FACES[f];
+
+            for (int slice = 0; slice < CHUNK_SIZE; slice++)
+            {
+                for (int u = 0; u < CHUNK_SIZE; u++)
+                {
+                    for (int v = 0; v < CHUNK_SIZE; v++)
+                    {
+                        int position[3];
+                        position[face.normalAxis] = slice;
+                        position[face.uAxis] = u;
+                        position[face.vAxis] = v;
+
+                        uint8_t block = _paddedBlocks[PaddedChunkIndex(position[0], position[1], position[2])];
+                        mask[u][v] = 0;
+
+                        if (block == 0 || !_blockInfo[block].cube)
+                            continue;
+
+                        position[face.normalAxis] += face.normalSign;
+                        uint8_t neighbour = _paddedBlocks[PaddedChunkIndex(position[0], position[1], position[2])];
+
+                        if (IsFaceVisible(block, neighbour, _blockInfo))
+                            mask[u][v] = block;
+                    }
+                }
+
+                for (int u = 0; u < CHUNK_SIZE; u++)
+                {
+                    for (int v = 0; v < CHUNK_SIZE; v++)
+                    {
+                        uint8_t block = mask[u][v];
+
+                        if (block == 0)
+                            continue;
+
+                        int width = 1;
+                        int height = 1;
+
+                        if (_mode == MeshingMode::GREEDY)
+                        {
+                            // grow along v first then along u while the whole column matches
+                            while (v + height < CHUNK_SIZE && mask[u][v + height] == block)
+                                height++;
+
+                            bool canGrow = true;
+                            while (canGrow && u + width < CHUNK_SIZE)
+                            {
+                                for (int k = 0; k < height; k++)
+                                {
+                                    if (mask[u + width][v + k] != block)
+                                    {
+                                        canGrow = false;
+                                        break;
+                                    }
+                                }
+
+                                if (canGrow)
+                                    width++;
+                            }
+                        }
+
+                        for (int du = 0; du < width; du++)
+                            for (int dv = 0; dv < height; dv++)
+                                mask[u + du][v + dv] = 0;
+
+                        EmitQuad(_vertices, face, _blockInfo[block].layers[f], slice, u, v, width, height);
+                    }
+                }
+            }
+        }
+    }
+} // end of Canis namespace
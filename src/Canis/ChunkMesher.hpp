@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "MeshFile.hpp"
+
+namespace Canis
+{
+    const int CHUNK_SIZE = 16;
+    // chunks are meshed with a one block border copied from their neighbours
+    const int CHUNK_PADDED_SIZE = CHUNK_SIZE + 2;
+    const int CHUNK_PADDED_VOLUME = CHUNK_PADDED_SIZE * CHUNK_PADDED_SIZE * CHUNK_PADDED_SIZE;
+    const int MAX_BLOCK_TYPES = 256;
+
+    // position, normal, uv and the texture array layer of the face, the layer sits after the instance attributes at 3 - 7
+    const int CHUNK_VERTEX_FLOATS = 9;
+    const MeshAttribute CHUNK_VERTEX_ATTRIBUTES[4] = {{0, 3, 0}, {1, 3, 3 * sizeof(float)}, {2, 2, 6 * sizeof(float)}, {8, 1, 8 * sizeof(float)}};
+
+    enum class MeshingMode
+    {
+        PER_FACE, // two triangles for every visible face
+        GREEDY    // merges coplanar faces of the same block into larger quads, needs GL_REPEAT textures
+    };
+
+    struct BlockInfo
+    {
+        bool cube = false;        // meshed into chunks, other blocks are spawned as entities
+        bool transparent = false; // faces behind it stay visible
+        float layers[6] = {};     // texture array layer of the +x, -x, +y, -y, +z and -z faces
+    };
+
+    // _x, _y and _z range from -1 to CHUNK_SIZE
+    inline int PaddedChunkIndex(int _x, int _y, int _z)
+    {
+        return ((_y + 1) * CHUNK_PADDED_SIZE + (_x + 1)) * CHUNK_PADDED_SIZE + (_z + 1);
+    }
+
+    // builds one mesh for the whole chunk, each face samples its block's layer of the texture array, only faces next to air or transparent blocks are emitted
+    // vertices are relative to the chunk origin and block (x, y, z) is centered on (x, y, z) like cube.obj
+    extern void BuildChunkMesh(const uint8_t *_paddedBlocks, const BlockInfo *_blockInfo, std::vector<float> &_vertices, MeshingMode _mode);
+} // end of Canis namespace
@@ -0,0 +1,265 @@
+#include "ChunkStreamer.hpp"
+#include "Debug.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+namespace Canis
+{
+    void ChunkStreamer::Start(const BlockInfo *_blockInfo, FillChunk _fill, LoadChunk _load, EvictChunk _evict, glm::ivec3 _minChunk, glm::ivec3 _maxChunk)
+    {
+        Stop();
+
+        m_blockInfo = _blockInfo;
+        m_fill = _fill;
+        m_load = _load;
+        m_evict = _evict;
+        m_minChunk = _minChunk;
+        m_maxChunk = _maxChunk;
+        m_stats = StreamingStats();
+        m_totalLatency = 0.0;
+        m_warnedBudget = false;
+        m_started = true;
+
+        SetRadius(m_radius);
+    }
+
+    void ChunkStreamer::Stop()
+    {
+        if (!m_started)
+            return;
+
+        // the jobs use the callbacks and this streamer
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock, [this]() { return m_running == 0; });
+            m_meshed.clear();
+        }
+
+        while (!m_resident.empty())
+            Evict(m_resident.begin());
+
+        m_pending.clear();
+        m_ready.clear();
+        m_generation++;
+        m_started = false;
+        m_stats.pendingChunks = 0;
+    }
+
+    void ChunkStreamer::SetRadius(int _radius)
+    {
+        m_radius = std::max(0, _radius);
+        m_columns.clear();
+
+        for (int x = -m_radius; x <= m_radius; x++)
+            for (int z = -m_radius; z <= m_radius; z++)
+                if (x * x + z * z <= m_radius * m_radius)
+                    m_columns.push_back(glm::ivec2(x, z));
+
+        std::sort(m_columns.begin(), m_columns.end(), [](glm::ivec2 _a, glm::ivec2 _b)
+                  { return _a.x * _a.x + _a.y * _a.y < _b.x * _b.x + _b.y * _b.y; });
+    }
+
+    void ChunkStreamer::SetMode(MeshingMode _mode)
+    {
+        if (_mode == m_mode)
+            return;
+
+        // the resident chunks are now stale and get requested again by Update
+        m_mode = _mode;
+        m_generation++;
+        m_pending.clear();
+        m_ready.clear();
+    }
+
+    void ChunkStreamer::Update(glm::vec3 _position)
+    {
+        if (!m_started)
+            return;
+
+        m_frame++;
+        glm::ivec3 center = glm::ivec3(glm::floor(_position / (float)CHUNK_SIZE));
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (Meshed &meshed : m_meshed)
+                m_ready.push_back(std::move(meshed));
+            m_meshed.clear();
+        }
+
+        // hand the finished meshes to the game, a few uploads per frame
+        int loads = 0;
+        auto now = std::chrono::steady_clock::now();
+
+        while (!m_ready.empty() && loads < m_loadsPerFrame)
+        {
+            Meshed meshed = std::move(m_ready.front());
+            m_ready.pop_front();
+
+            if (meshed.generation != m_generation)
+                continue;
+
+            uint64_t key = ChunkKey(meshed.chunk);
+            auto pending = m_pending.find(key);
+            if (pending == m_pending.end())
+                continue;
+
+            double latency = std::chrono::duration<double>(now - pending->second).count();
+            m_pending.erase(pending);
+
+            // kept as an empty chunk so the pending slot frees up, it is tried again after an eviction or SetMode
+            if (!meshed.error.empty())
+            {
+                Error("Chunk " + std::to_string(meshed.chunk.x) + ", " + std::to_string(meshed.chunk.y) + ", " + std::to_string(meshed.chunk.z) +
+                      " could not be streamed: " + meshed.error);
+                m_stats.failed++;
+            }
+
+            // flown past while it was meshed
+            glm::ivec2 offset = glm::ivec2(meshed.chunk.x - center.x, meshed.chunk.z - center.z);
+            if (offset.x * offset.x + offset.y * offset.y > (m_radius + 1) * (m_radius + 1))
+                continue;
+
+            size_t vertexBytes = meshed.vertices.size() * sizeof(float);
+            auto resident = m_resident.find(key);
+
+            if (resident == m_resident.end())
+            {
+                m_lru.push_front(key);
+                resident = m_resident.emplace(key, Resident{m_lru.begin(), meshed.chunk, m_frame, m_generation, 0}).first;
+            }
+
+            // empty chunks are loaded too, only the ones with vertices count as an upload
+            m_load(meshed.chunk, meshed.vertices);
+            if (vertexBytes > 0)
+                loads++;
+
+            if (resident->second.vertexBytes > 0)
+                m_stats.meshedChunks--;
+            if (vertexBytes > 0)
+                m_stats.meshedChunks++;
+            m_stats.vertexBytes = m_stats.vertexBytes - resident->second.vertexBytes + vertexBytes;
+            resident->second.vertexBytes = vertexBytes;
+            resident->second.generation = m_generation;
+
+            m_stats.loaded++;
+            m_stats.lastLatency = latency;
+            m_stats.worstLatency = std::max(m_stats.worstLatency, latency);
+            m_totalLatency += latency;
+            m_stats.averageLatency = m_totalLatency / m_stats.loaded;
+        }
+
+        // nearest columns first, the thread pool only gets a few jobs per thread so new nearby chunks are not stuck behind far ones
+        size_t maxPending = 2 * GetThreadPool().GetThreadCount() + m_loadsPerFrame;
+
+        for (glm::ivec2 column : m_columns)
+        {
+            int x = center.x + column.x;
+            int z = center.z + column.y;
+
+            if (x < m_minChunk.x || z < m_minChunk.z || x >= m_maxChunk.x || z >= m_maxChunk.z)
+                continue;
+
+            for (int y = m_minChunk.y; y < m_maxChunk.y; y++)
+            {
+                glm::ivec3 chunk = glm::ivec3(x, y, z);
+                uint64_t key = ChunkKey(chunk);
+
+                auto resident = m_resident.find(key);
+                if (resident != m_resident.end())
+                {
+                    m_lru.splice(m_lru.begin(), m_lru, resident->second.lru);
+                    resident->second.frame = m_frame;
+
+                    if (resident->second.generation == m_generation)
+                        continue;
+                }
+
+                if (m_pending.size() < maxPending && m_pending.find(key) == m_pending.end())
+                    Request(chunk);
+            }
+        }
+
+        // the back of the list was wanted longest ago
+        while (m_resident.size() > m_budget)
+        {
+            auto resident = m_resident.find(m_lru.back());
+            if (resident->second.frame == m_frame)
+            {
+                if (!m_warnedBudget)
+                    Warning("Chunk streaming radius " + std::to_string(m_radius) + " needs more than the budget of " + std::to_string(m_budget) + " chunks");
+                m_warnedBudget = true;
+                break;
+            }
+
+            Evict(resident);
+        }
+
+        m_stats.residentChunks = m_resident.size();
+        m_stats.pendingChunks = m_pending.size();
+    }
+
+    bool ChunkStreamer::IsResident(glm::ivec3 _chunk) const
+    {
+        auto resident = m_resident.find(ChunkKey(_chunk));
+        return resident != m_resident.end() && resident->second.generation == m_generation;
+    }
+
+    void ChunkStreamer::Request(glm::ivec3 _chunk)
+    {
+        m_pending[ChunkKey(_chunk)] = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running++;
+        }
+
+        GetThreadPool().Submit([this, _chunk, generation = m_generation, mode = m_mode]()
+        {
+            Meshed meshed;
+            meshed.chunk = _chunk;
+            meshed.generation = generation;
+
+            try
+            {
+                std::vector<uint8_t> paddedBlocks(CHUNK_PADDED_VOLUME);
+                m_fill(_chunk, paddedBlocks.data());
+                BuildChunkMesh(paddedBlocks.data(), m_blockInfo, meshed.vertices, mode);
+            }
+            catch (const std::exception &_exception)
+            {
+                meshed.error = _exception.what();
+            }
+            catch (...)
+            {
+                meshed.error = "unknown exception";
+            }
+
+            // a failure goes back too so Update frees its pending slot
+            if (!meshed.error.empty())
+                meshed.vertices.clear();
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_meshed.push_back(std::move(meshed));
+            m_running--;
+            m_idle.notify_all();
+        });
+    }
+
+    void ChunkStreamer::Evict(std::unordered_map<uint64_t, Resident>::iterator _resident)
+    {
+        m_evict(_resident->second.chunk);
+
+        if (_resident->second.vertexBytes > 0)
+        {
+            m_stats.meshedChunks--;
+            m_stats.vertexBytes -= _resident->second.vertexBytes;
+        }
+
+        m_stats.evicted++;
+        m_lru.erase(_resident->second.lru);
+        m_resident.erase(_resident);
+    }
+} // end of Canis namespace
@@ -0,0 +1,137 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ChunkMesher.hpp"
+
+namespace Canis
+{
+    // packs a chunk coordinate into one integer for hash maps, each axis keeps 21 bits
+    inline uint64_t ChunkKey(glm::ivec3 _chunk)
+    {
+        const uint64_t MASK = (1u << 21) - 1;
+        return ((uint64_t)(_chunk.x & MASK) << 42) | ((uint64_t)(_chunk.y & MASK) << 21) | (uint64_t)(_chunk.z & MASK);
+    }
+
+    struct StreamingStats
+    {
+        size_t residentChunks = 0; // meshed chunks kept around, empty ones included
+        size_t meshedChunks = 0;   // resident chunks with vertices
+        size_t pendingChunks = 0;  // requested and not handed to the game yet
+        size_t vertexBytes = 0;    // vertices of the resident chunks
+        unsigned int loaded = 0;   // chunks handed to the game since Start
+        unsigned int evicted = 0;
+        unsigned int failed = 0;   // fills or meshes that threw, those chunks are kept empty
+        double lastLatency = 0.0; // seconds from request to upload
+        double averageLatency = 0.0;
+        double worstLatency = 0.0;
+    };
+
+    // keeps the chunks within a radius of a position meshed, the far ones are evicted least recently used first
+    // filling and meshing run on the thread pool, the callbacks run on the thread calling Update
+    class ChunkStreamer
+    {
+    public:
+        // fills a CHUNK_PADDED_VOLUME buffer with the blocks of _chunk and its border, runs on the thread pool
+        typedef std::function<void(glm::ivec3 _chunk, uint8_t *_paddedBlocks)> FillChunk;
+        // _chunk is resident, called again with the new vertices when it is remeshed
+        // _vertices is empty for a chunk with no cube faces, the game may still have things standing in it
+        typedef std::function<void(glm::ivec3 _chunk, const std::vector<float> &_vertices)> LoadChunk;
+        // the chunk was evicted, called once for every chunk that was loaded
+        typedef std::function<void(glm::ivec3 _chunk)> EvictChunk;
+
+        ChunkStreamer() {}
+        ~ChunkStreamer() { Stop(); }
+
+        ChunkStreamer(const ChunkStreamer &) = delete;
+        ChunkStreamer &operator=(const ChunkStreamer &) = delete;
+
+        // chunks outside _minChunk to _maxChunk (exclusive) are never requested
+        void Start(const BlockInfo *_blockInfo, FillChunk _fill, LoadChunk _load, EvictChunk _evict, glm::ivec3 _minChunk, glm::ivec3 _maxChunk);
+        // evicts every chunk and waits for the jobs still on the thread pool
+        void Stop();
+        bool IsStarted() const { return m_started; }
+
+        // in chunks around the position on x and z, every chunk of the column is loaded
+        void SetRadius(int _radius);
+        int GetRadius() const { return m_radius; }
+        // resident chunks kept before the least recently used ones go, chunks inside the radius are never evicted
+        void SetBudget(size_t _chunks) { m_budget = _chunks; }
+        size_t GetBudget() const { return m_budget; }
+        // meshes handed to LoadChunk per Update, the uploads of one frame
+        void SetLoadsPerFrame(int _loads) { m_loadsPerFrame = _loads; }
+        // resident chunks keep their mesh until the remeshed one is loaded
+        void SetMode(MeshingMode _mode);
+
+        // call once per frame with the camera position
+        void Update(glm::vec3 _position);
+
+        // meshed with the current mode, empty chunks count too
+        bool IsResident(glm::ivec3 _chunk) const;
+
+        const StreamingStats &GetStats() const { return m_stats; }
+
+    private:
+        struct Resident
+        {
+            std::list<uint64_t>::iterator lru;
+            glm::ivec3 chunk;
+            unsigned int frame = 0;      // last Update that wanted it
+            unsigned int generation = 0; // m_generation it was meshed with
+            size_t vertexBytes = 0;
+        };
+
+        struct Meshed
+        {
+            glm::ivec3 chunk;
+            unsigned int generation = 0;
+            std::vector<float> vertices = {};
+            std::string error = {}; // why filling or meshing threw, empty when it worked
+        };
+
+        void Request(glm::ivec3 _chunk);
+        void Evict(std::unordered_map<uint64_t, Resident>::iterator _resident);
+
+        const BlockInfo *m_blockInfo = nullptr;
+        FillChunk m_fill;
+        LoadChunk m_load;
+        EvictChunk m_evict;
+        glm::ivec3 m_minChunk = glm::ivec3(0);
+        glm::ivec3 m_maxChunk = glm::ivec3(0);
+        bool m_started = false;
+
+        int m_radius = 8;
+        size_t m_budget = 4096;
+        int m_loadsPerFrame = 8;
+        MeshingMode m_mode = MeshingMode::GREEDY;
+
+        // bumped by SetMode and Stop, meshes of an older generation are thrown away
+        unsigned int m_generation = 0;
+        unsigned int m_frame = 0;
+        // x, z offsets inside the radius, nearest first
+        std::vector<glm::ivec2> m_columns = {};
+
+        std::unordered_map<uint64_t, Resident> m_resident = {};
+        std::list<uint64_t> m_lru = {}; // most recently wanted first
+        std::unordered_map<uint64_t, std::chrono::steady_clock::time_point> m_pending = {}; // when each chunk was requested
+        std::deque<Meshed> m_ready = {}; // meshes waiting for their frame to be loaded
+        bool m_warnedBudget = false;
+
+        // filled by the thread pool
+        std::mutex m_mutex;
+        std::condition_variable m_idle;
+        std::vector<Meshed> m_meshed = {};
+        unsigned int m_running = 0;
+
+        StreamingStats m_stats;
+        double m_totalLatency = 0.0;
+    };
+} // end of Canis namespace
@@ -7,5 +7,6 @@ namespace Canis
 		unsigned int id;
 		int width;
 		int height;
+		int layers = 0; // frames of a GL_TEXTURE_2D_ARRAY, 0 for a plain GL_TEXTURE_2D
 	};
 }
\ No newline at end of file
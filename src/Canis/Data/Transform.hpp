@@ -3,13 +3,32 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace Canis {
+    // the world matrix is cached and only rebuilt after position, rotation or scale change
+    // change them through the setters, or call MarkDirty after writing the fields directly
     struct Transform
     {
         glm::vec3 position = glm::vec3(0.0f);
         glm::vec3 rotation = glm::vec3(0.0f);
         glm::vec3 scale = glm::vec3(1.0f);
 
-        glm::mat4 Matrix() {
+        // rebuilt by Matrix() or in batches by EntityStorage::UpdateMatrices
+        glm::mat4 matrix = glm::mat4(1.0f);
+        bool dirty = true;
+
+        void SetPosition(const glm::vec3 &_position) { position = _position; dirty = true; }
+        void SetRotation(const glm::vec3 &_rotation) { rotation = _rotation; dirty = true; }
+        void SetScale(const glm::vec3 &_scale) { scale = _scale; dirty = true; }
+        void MarkDirty() { dirty = true; }
+
+        const glm::mat4& Matrix() {
+            if (dirty) {
+                matrix = BuildMatrix();
+                dirty = false;
+            }
+            return matrix;
+        }
+
+        glm::mat4 BuildMatrix() const {
             glm::mat4 transform = glm::mat4(1.0f);
             transform = glm::translate(transform, position);
             transform = glm::rotate(transform, rotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace Canis
+{
+    // binding points, Shader::Link binds any block with these names automatically
+    const unsigned int FRAME_BLOCK_BINDING = 0;
+    const unsigned int LIGHT_BLOCK_BINDING = 1;
+    const char *const FRAME_BLOCK_NAME = "FrameData";
+    const char *const LIGHT_BLOCK_NAME = "LightData";
+
+    const int MAX_POINT_LIGHTS = 4;
+
+    // these mirror the std140 layout of the blocks declared in assets/shaders
+    struct FrameBlock
+    {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec3 viewPosition;
+        float time;
+    };
+
+    struct DirectionalLightStd140
+    {
+        glm::vec4 direction;
+        glm::vec4 ambient;
+        glm::vec4 diffuse;
+        glm::vec4 specular;
+    };
+
+    struct PointLightStd140
+    {
+        glm::vec4 position;
+        glm::vec4 ambient;
+        glm::vec4 diffuse;
+        glm::vec3 specular;
+        float constant; // packs into the last 4 bytes of specular
+        float linear;
+        float quadratic;
+        float padding[2];
+    };
+
+    struct LightBlock
+    {
+        DirectionalLightStd140 directionalLight;
+        PointLightStd140 pointLights[MAX_POINT_LIGHTS];
+        int numberOfPointLights;
+        int padding[3];
+    };
+
+    static_assert(sizeof(FrameBlock) == 144);
+    static_assert(sizeof(PointLightStd140) == 80);
+    static_assert(offsetof(LightBlock, pointLights) == 64);
+    static_assert(offsetof(LightBlock, numberOfPointLights) == 384);
+} // end of Canis namespace
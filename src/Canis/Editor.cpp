@@ -1,5 +1,6 @@
 #include "Editor.hpp"
 #include "Debug.hpp"
+#include "AssetManager.hpp"
 
 #include <SDL.h>
 #include <GL/glew.h>
@@ -64,9 +65,7 @@ namespace Canis
 
         // Set up id shader
         m_idShader.Compile("assets/shaders/id_shader.vs", "assets/shaders/id_shader.fs");
-        m_idShader.AddAttribute("model");
-        m_idShader.AddAttribute("view");
-        m_idShader.AddAttribute("projection");
+        m_idShader.AddAttribute("aPos");
         m_idShader.Link();
     }
 
@@ -77,23 +76,18 @@ namespace Canis
             glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-            mat4 project = mat4(1.0f);
-            project = perspective(radians(45.0f),
-                              (float)m_window->GetScreenWidth() / (float)m_window->GetScreenHeight(),
-                              0.01f, 100.0f);
-
-            // Set up your shaders and matrices
+            // view and projection come from the frame uniform block World filled this frame
             m_idShader.Use();
-            m_idShader.SetMat4("view", m_camera->GetViewMatrix());
-            m_idShader.SetMat4("projection", project);
 
-            // Render each entity with its unique ID
-            auto& entities = m_world->GetEntities();
-            int size = entities.size();
+            // Render each entity with its index as the ID
+            EntityStorage &entities = m_world->GetEntities();
+            std::vector<Transform> &transforms = entities.GetTransforms();
+            std::vector<RenderData> &renderData = entities.GetRenderData();
+            int size = entities.Size();
             for (int i = 0; i < size; i++) {
-                m_idShader.SetMat4("model", entities[i].transform.Matrix());
-                m_idShader.SetInt("entityID", i);
-                Canis::Draw(*entities[i].model);
+                m_idShader.SetMat4(UniformId("model"), transforms[i].Matrix());
+                m_idShader.SetInt(UniformId("entityID"), i);
+                Canis::Draw(*renderData[i].model);
             }
 
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
@@ -130,7 +124,13 @@ namespace Canis
             if (count == 0)
                 return;
 
-            Entity *entity = m_world->GetEntity(m_index);
+            // despawning can shrink the list under the selection
+            if (m_index >= count)
+                m_index = count - 1;
+
+            EntityStorage &entities = m_world->GetEntities();
+            EntityHandle entity = entities.GetHandle(m_index);
+            Transform &transform = entities.GetTransform(entity);
 
             ImGui::Begin("Hello, world!"); // Create a window called "Hello, world!" and append into it.
 
@@ -152,19 +152,66 @@ namespace Canis
                     m_index = 0;
             }
 
-            ImGui::Checkbox("active", &(entity->active));
-            ImGui::InputText("tag", &(entity->tag));
+            bool active = entities.IsActive(entity);
+            if (ImGui::Checkbox("active", &active))
+                entities.SetActive(entity, active);
+            ImGui::InputText("tag", &(entities.GetTag(entity)));
 
             if (ImGui::CollapsingHeader("Transform"))
             {
-                ImGui::InputFloat3("Position", glm::value_ptr(entity->transform.position), "%.3f");
-                ImGui::InputFloat3("Rotation", glm::value_ptr(entity->transform.rotation));
-                ImGui::InputFloat3("Scale", glm::value_ptr(entity->transform.scale));
+                bool changed = false;
+                changed |= ImGui::InputFloat3("Position", glm::value_ptr(transform.position), "%.3f");
+                changed |= ImGui::InputFloat3("Rotation", glm::value_ptr(transform.rotation));
+                changed |= ImGui::InputFloat3("Scale", glm::value_ptr(transform.scale));
+
+                if (changed)
+                    transform.MarkDirty();
             }
 
             if (ImGui::CollapsingHeader("Material"))
             {
-                ImGui::InputFloat3("Color", glm::value_ptr(entity->color));
+                ImGui::InputFloat3("Color", glm::value_ptr(entities.GetRenderData(entity).color));
+            }
+
+            if (ImGui::CollapsingHeader("Rendering"))
+            {
+                bool instancing = m_world->GetInstancing();
+                if (ImGui::Checkbox("instancing", &instancing))
+                    m_world->SetInstancing(instancing);
+
+                bool frustumCulling = m_world->GetFrustumCulling();
+                if (ImGui::Checkbox("frustum culling", &frustumCulling))
+                    m_world->SetFrustumCulling(frustumCulling);
+
+                const RenderStats &stats = m_world->GetRenderStats();
+                ImGui::Text("Visible: %u Culled: %u", stats.visibleEntities, stats.culledEntities);
+                ImGui::Text("Draw calls: %u", stats.drawCalls);
+                ImGui::Text("Matrices updated: %u", stats.matricesUpdated);
+                ImGui::Text("Instanced batches: %u", stats.instancedBatches);
+                ImGui::Text("Entities drawn: %u", stats.entitiesDrawn);
+                ImGui::Text("Program switches: %u", stats.programSwitches);
+                ImGui::Text("Texture binds: %u", stats.textureBinds);
+                ImGui::Text("VAO binds: %u", stats.vaoBinds);
+                ImGui::Text("Frame time: %.3f ms (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+            }
+
+            if (ImGui::CollapsingHeader("Assets"))
+            {
+                const AssetStats &stats = GetAssetManager().GetStats();
+                ImGui::Text("Hits: %u Misses: %u Released: %u", stats.hits, stats.misses, stats.released);
+                ImGui::Text("Textures: %u (%zu KB)", stats.textures, stats.textureBytes / 1024);
+                ImGui::Text("Models: %u (%zu KB)", stats.models, stats.modelBytes / 1024);
+                ImGui::Text("Shaders: %u", stats.shaders);
+            }
+
+            if (m_streamer != nullptr && ImGui::CollapsingHeader("Streaming"))
+            {
+                const StreamingStats &stats = m_streamer->GetStats();
+                ImGui::Text("Resident: %zu / %zu chunks (%zu meshed)", stats.residentChunks, m_streamer->GetBudget(), stats.meshedChunks);
+                ImGui::Text("Vertices: %zu KB", stats.vertexBytes / 1024);
+                ImGui::Text("Pending: %zu", stats.pendingChunks);
+                ImGui::Text("Loaded: %u Evicted: %u Failed: %u", stats.loaded, stats.evicted, stats.failed);
+                ImGui::Text("Latency: last %.1f ms avg %.1f ms worst %.1f ms", stats.lastLatency * 1000.0, stats.averageLatency * 1000.0, stats.worstLatency * 1000.0);
             }
 
             // ImGui::ColorEdit3("clear color", (float *)&clear_color); // Edit 3 floats representing a color
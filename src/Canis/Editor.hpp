@@ -1,6 +1,7 @@
 #pragma once
 
 #include "World.hpp"
+#include "ChunkStreamer.hpp"
 #include "Window.hpp"
 
 namespace Canis
@@ -9,11 +10,14 @@ class Editor {
 public:
     Editor(Window *_window, World *_world, InputManager *_inputManager);
     void Draw();
+    // shows the streaming stats, nullptr hides them
+    void SetChunkStreamer(const ChunkStreamer *_streamer) { m_streamer = _streamer; }
 private:
     Window *m_window;
     World *m_world;
     Camera *m_camera;
     InputManager *m_inputManager;
+    const ChunkStreamer *m_streamer = nullptr;
     bool showExtra = true;
     int m_index = 0;
     unsigned int m_fbo, m_texture, m_rbo;
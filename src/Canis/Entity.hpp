@@ -9,18 +9,41 @@ namespace Canis
 {
     class World;
 
+    // refers to an entity in World, stops being valid once that entity is despawned
+    struct EntityHandle
+    {
+        unsigned int slot = ~0u;
+        unsigned int generation = 0;
+    };
+
+    // what World needs to draw an entity, stored in its own array so draw loops skip names and tags
+    struct RenderData
+    {
+        Model *model = nullptr;
+        Shader *shader = nullptr;
+        GLTexture *albedo = nullptr;
+        GLTexture *specular = nullptr;
+        GLTexture *emission = nullptr;
+        glm::vec3 color = glm::vec3(1.0f);
+        bool transparent = false;
+    };
+
+    typedef void (*UpdateFunction)(World &_world, EntityHandle _entity, float _deltaTime);
+
+    // describes an entity to spawn, World splits the fields into separate arrays
     struct Entity
     {
         bool active = true;
         std::string name;
         std::string tag;
         Transform transform;
-        Model *model;
-        Shader *shader;
+        Model *model = nullptr;
+        Shader *shader = nullptr;
         glm::vec3 color = glm::vec3(1.0f);
-        GLTexture *albedo;
-        GLTexture *specular;
-        GLTexture *emission;
-        void (*Update)(World &_world, Entity &_entity, float _deltaTime) = nullptr;
+        GLTexture *albedo = nullptr;
+        GLTexture *specular = nullptr;
+        GLTexture *emission = nullptr;
+        bool transparent = false; // blended, drawn after every opaque entity from back to front
+        UpdateFunction Update = nullptr;
     };
-}
\ No newline at end of file
+}
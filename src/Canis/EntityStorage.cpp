@@ -0,0 +1,165 @@
+#include "EntityStorage.hpp"
+
+#include <utility>
+#include <cmath>
+#include <algorithm>
+
+namespace Canis
+{
+    EntityHandle EntityStorage::Spawn(const Entity &_entity)
+    {
+        unsigned int slot;
+
+        if (m_freeSlots.empty())
+        {
+            slot = m_slotToIndex.size();
+            m_slotToIndex.push_back(0);
+            m_slotGenerations.push_back(0);
+        }
+        else
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+
+        m_slotToIndex[slot] = m_transforms.size();
+        m_indexToSlot.push_back(slot);
+
+        m_active.push_back(_entity.active);
+        m_transforms.push_back(_entity.transform);
+        m_updates.push_back(_entity.Update);
+        m_tags.push_back(_entity.tag);
+        m_names.push_back(_entity.name);
+
+        RenderData renderData;
+        renderData.model = _entity.model;
+        renderData.shader = _entity.shader;
+        renderData.albedo = _entity.albedo;
+        renderData.specular = _entity.specular;
+        renderData.emission = _entity.emission;
+        renderData.color = _entity.color;
+        renderData.transparent = _entity.transparent;
+        m_renderData.push_back(renderData);
+
+        return {slot, m_slotGenerations[slot]};
+    }
+
+    void EntityStorage::Despawn(EntityHandle _entity)
+    {
+        if (!IsValid(_entity))
+            return;
+
+        unsigned int index = m_slotToIndex[_entity.slot];
+        unsigned int last = m_transforms.size() - 1;
+
+        if (index != last)
+        {
+            m_active[index] = m_active[last];
+            m_transforms[index] = m_transforms[last];
+            m_renderData[index] = m_renderData[last];
+            m_updates[index] = m_updates[last];
+            m_tags[index] = std::move(m_tags[last]);
+            m_names[index] = std::move(m_names[last]);
+
+            m_indexToSlot[index] = m_indexToSlot[last];
+            m_slotToIndex[m_indexToSlot[index]] = index;
+        }
+
+        m_active.pop_back();
+        m_transforms.pop_back();
+        m_renderData.pop_back();
+        m_updates.pop_back();
+        m_tags.pop_back();
+        m_names.pop_back();
+        m_indexToSlot.pop_back();
+
+        // old handles to this slot stop matching
+        m_slotGenerations[_entity.slot]++;
+        m_freeSlots.push_back(_entity.slot);
+    }
+
+    bool EntityStorage::IsValid(EntityHandle _entity) const
+    {
+        return _entity.slot < m_slotGenerations.size() && m_slotGenerations[_entity.slot] == _entity.generation &&
+               m_slotToIndex[_entity.slot] < m_indexToSlot.size() && m_indexToSlot[m_slotToIndex[_entity.slot]] == _entity.slot;
+    }
+
+    unsigned int EntityStorage::UpdateMatrices()
+    {
+        m_dirtyIndices.clear();
+
+        for (unsigned int i = 0; i < m_transforms.size(); i++)
+            if (m_transforms[i].dirty)
+                m_dirtyIndices.push_back(i);
+
+        // dirty transforms are gathered into float arrays in blocks so each step is a plain loop the compiler can vectorize
+        const int BLOCK = 64;
+        float px[BLOCK], py[BLOCK], pz[BLOCK];
+        float rx[BLOCK], ry[BLOCK], rz[BLOCK];
+        float sx[BLOCK], sy[BLOCK], sz[BLOCK];
+        float sinX[BLOCK], cosX[BLOCK], sinY[BLOCK], cosY[BLOCK], sinZ[BLOCK], cosZ[BLOCK];
+        float m[9][BLOCK];
+
+        for (size_t first = 0; first < m_dirtyIndices.size(); first += BLOCK)
+        {
+            int count = std::min<size_t>(BLOCK, m_dirtyIndices.size() - first);
+
+            for (int i = 0; i < count; i++)
+            {
+                const Transform &transform = m_transforms[m_dirtyIndices[first + i]];
+                px[i] = transform.position.x;
+                py[i] = transform.position.y;
+                pz[i] = transform.position.z;
+                sx[i] = transform.scale.x;
+                sy[i] = transform.scale.y;
+                sz[i] = transform.scale.z;
+                rx[i] = transform.rotation.x;
+                ry[i] = transform.rotation.y;
+                rz[i] = transform.rotation.z;
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                sinX[i] = std::sin(rx[i]);
+                cosX[i] = std::cos(rx[i]);
+                sinY[i] = std::sin(ry[i]);
+                cosY[i] = std::cos(ry[i]);
+                sinZ[i] = std::sin(rz[i]);
+                cosZ[i] = std::cos(rz[i]);
+            }
+
+            // same result as Transform::BuildMatrix, translate * rotateX * rotateY * rotateZ * scale written out
+            // m[column * 3 + row] of the upper 3x3
+            for (int i = 0; i < count; i++)
+            {
+                m[0][i] = cosY[i] * cosZ[i] * sx[i];
+                m[1][i] = (cosX[i] * sinZ[i] + sinX[i] * sinY[i] * cosZ[i]) * sx[i];
+                m[2][i] = (sinX[i] * sinZ[i] - cosX[i] * sinY[i] * cosZ[i]) * sx[i];
+                m[3][i] = -cosY[i] * sinZ[i] * sy[i];
+                m[4][i] = (cosX[i] * cosZ[i] - sinX[i] * sinY[i] * sinZ[i]) * sy[i];
+                m[5][i] = (sinX[i] * cosZ[i] + cosX[i] * sinY[i] * sinZ[i]) * sy[i];
+                m[6][i] = sinY[i] * sz[i];
+                m[7][i] = -sinX[i] * cosY[i] * sz[i];
+                m[8][i] = cosX[i] * cosY[i] * sz[i];
+            }
+
+            for (int i = 0; i < count; i++)
+            {
+                Transform &transform = m_transforms[m_dirtyIndices[first + i]];
+                transform.matrix[0] = glm::vec4(m[0][i], m[1][i], m[2][i], 0.0f);
+                transform.matrix[1] = glm::vec4(m[3][i], m[4][i], m[5][i], 0.0f);
+                transform.matrix[2] = glm::vec4(m[6][i], m[7][i], m[8][i], 0.0f);
+                transform.matrix[3] = glm::vec4(px[i], py[i], pz[i], 1.0f);
+                transform.dirty = false;
+            }
+        }
+
+        return m_dirtyIndices.size();
+    }
+
+    void EntityStorage::Clear()
+    {
+        while (Size() > 0)
+            Despawn(GetHandle(Size() - 1));
+    }
+} // end of Canis namespace
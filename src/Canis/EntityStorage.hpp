@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Entity.hpp"
+
+namespace Canis
+{
+    // entities stored as parallel arrays, index i of every array is the same entity
+    // despawning moves the last entity into the hole so the arrays stay packed, handles go through a slot table
+    class EntityStorage
+    {
+    public:
+        EntityHandle Spawn(const Entity &_entity);
+        void Despawn(EntityHandle _entity);
+        bool IsValid(EntityHandle _entity) const;
+        void Clear();
+
+        // rebuilds the cached matrix of every dirty transform, returns how many were rebuilt
+        unsigned int UpdateMatrices();
+
+        unsigned int Size() const { return m_transforms.size(); }
+
+        // indices change when entities are despawned, handles do not
+        EntityHandle GetHandle(unsigned int _index) const { return {m_indexToSlot[_index], m_slotGenerations[m_indexToSlot[_index]]}; }
+        unsigned int GetIndex(EntityHandle _entity) const { return m_slotToIndex[_entity.slot]; }
+
+        Transform &GetTransform(EntityHandle _entity) { return m_transforms[GetIndex(_entity)]; }
+        RenderData &GetRenderData(EntityHandle _entity) { return m_renderData[GetIndex(_entity)]; }
+        std::string &GetTag(EntityHandle _entity) { return m_tags[GetIndex(_entity)]; }
+        std::string &GetName(EntityHandle _entity) { return m_names[GetIndex(_entity)]; }
+        bool IsActive(EntityHandle _entity) const { return m_active[GetIndex(_entity)]; }
+        void SetActive(EntityHandle _entity, bool _active) { m_active[GetIndex(_entity)] = _active; }
+
+        std::vector<uint8_t> &GetActive() { return m_active; }
+        std::vector<Transform> &GetTransforms() { return m_transforms; }
+        std::vector<RenderData> &GetRenderData() { return m_renderData; }
+        std::vector<UpdateFunction> &GetUpdates() { return m_updates; }
+        std::vector<std::string> &GetTags() { return m_tags; }
+        std::vector<std::string> &GetNames() { return m_names; }
+
+    private:
+        std::vector<uint8_t> m_active = {};
+        std::vector<Transform> m_transforms = {};
+        std::vector<RenderData> m_renderData = {};
+        std::vector<UpdateFunction> m_updates = {};
+        std::vector<std::string> m_tags = {};
+        std::vector<std::string> m_names = {};
+
+        std::vector<unsigned int> m_indexToSlot = {};
+        std::vector<unsigned int> m_slotToIndex = {};
+        std::vector<unsigned int> m_slotGenerations = {};
+        std::vector<unsigned int> m_freeSlots = {};
+
+        std::vector<unsigned int> m_dirtyIndices = {};
+    };
+} // end of Canis namespace
@@ -0,0 +1,66 @@
+#include "Frustum.hpp"
+
+namespace Canis
+{
+    Frustum Frustum::FromMatrix(const glm::mat4 &_viewProjection)
+    {
+        Frustum frustum;
+
+        // glm is column major so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+        glm::vec4 row[4];
+        for (int i = 0; i < 4; i++)
+            row[i] = glm::vec4(_viewProjection[0][i], _viewProjection[1][i], _viewProjection[2][i], _viewProjection[3][i]);
+
+        frustum.planes[0] = row[3] + row[0]; // left
+        frustum.planes[1] = row[3] - row[0]; // right
+        frustum.planes[2] = row[3] + row[1]; // bottom
+        frustum.planes[3] = row[3] - row[1]; // top
+        frustum.planes[4] = row[3] + row[2]; // near
+        frustum.planes[5] = row[3] - row[2]; // far
+
+        for (int i = 0; i < 6; i++)
+            frustum.planes[i] /= glm::length(glm::vec3(frustum.planes[i]));
+
+        return frustum;
+    }
+
+    bool Frustum::IntersectsSphere(const glm::vec3 &_center, float _radius) const
+    {
+        for (int i = 0; i < 6; i++)
+            if (glm::dot(glm::vec3(planes[i]), _center) + planes[i].w < -_radius)
+                return false;
+
+        return true;
+    }
+
+    bool Frustum::IntersectsAABB(const glm::vec3 &_center, const glm::vec3 &_extents) const
+    {
+        for (int i = 0; i < 6; i++)
+        {
+            glm::vec3 normal = glm::vec3(planes[i]);
+
+            // projected radius of the box onto the plane normal
+            float radius = glm::dot(_extents, glm::abs(normal));
+
+            if (glm::dot(normal, _center) + planes[i].w < -radius)
+                return false;
+        }
+
+        return true;
+    }
+
+    bool Frustum::IntersectsAABB(const glm::mat4 &_transform, const glm::vec3 &_min, const glm::vec3 &_max) const
+    {
+        glm::vec3 localCenter = (_min + _max) * 0.5f;
+        glm::vec3 localExtents = (_max - _min) * 0.5f;
+
+        glm::vec3 center = glm::vec3(_transform * glm::vec4(localCenter, 1.0f));
+        glm::vec3 extents = glm::vec3(0.0f);
+
+        for (int row = 0; row < 3; row++)
+            for (int column = 0; column < 3; column++)
+                extents[row] += glm::abs(_transform[column][row]) * localExtents[column];
+
+        return IntersectsAABB(center, extents);
+    }
+} // end of Canis namespace
@@ -0,0 +1,20 @@
+#pragma once
+#include <glm/glm.hpp>
+
+namespace Canis
+{
+    // planes point inwards, a point p is inside a plane when dot(normal, p) + distance >= 0
+    struct Frustum
+    {
+        glm::vec4 planes[6];
+
+        // extracts the planes from a projection * view matrix (Gribb/Hartmann)
+        static Frustum FromMatrix(const glm::mat4 &_viewProjection);
+
+        bool IntersectsSphere(const glm::vec3 &_center, float _radius) const;
+        bool IntersectsAABB(const glm::vec3 &_center, const glm::vec3 &_extents) const;
+
+        // transforms a local space box by _transform then tests the enclosing world space box
+        bool IntersectsAABB(const glm::mat4 &_transform, const glm::vec3 &_min, const glm::vec3 &_max) const;
+    };
+} // end of Canis namespace
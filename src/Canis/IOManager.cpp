@@ -5,95 +5,629 @@
 #include <GL/glew.h>
 #include <stb_image.h>
 #include <vector>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <algorithm>
 #include <glm/glm.hpp>
 
+#include "AssetPack.hpp"
+#include "Canis.hpp"
+#include "TextureFile.hpp"
+#include "ThreadPool.hpp"
+
 namespace Canis
 {
-	GLTexture LoadImageGL(std::string _path, bool _wrap)
+	namespace
 	{
-		return LoadImageGL(_path, GL_RGBA, GL_RGBA, _wrap);
+		// a corner index is 1 based, 0 when the face leaves that stream out
+		// negative obj indices are counted back from the end of the chunk they appear in and fixed up once every chunk is parsed
+		const uint8_t OBJ_RELATIVE_POSITION = 1;
+		const uint8_t OBJ_RELATIVE_UV = 2;
+		const uint8_t OBJ_RELATIVE_NORMAL = 4;
+
+		// a file is only split across threads in pieces of at least this size
+		const size_t OBJ_MIN_BYTES_PER_THREAD = 256 * 1024;
+
+		struct ObjCorner
+		{
+			int position = 0;
+			int uv = 0;
+			int normal = 0;
+			uint8_t relative = 0;
+		};
+
+		// a range of whole lines parsed by one thread
+		struct ObjChunk
+		{
+			const char *begin = nullptr;
+			const char *end = nullptr;
+			std::vector<glm::vec3> positions = {};
+			std::vector<glm::vec2> uvs = {};
+			std::vector<glm::vec3> normals = {};
+			std::vector<ObjCorner> corners = {};
+			std::vector<unsigned int> faceSizes = {};
+			size_t triangles = 0;
+			size_t firstPosition = 0;
+			size_t firstUV = 0;
+			size_t firstNormal = 0;
+			size_t firstTriangle = 0;
+			std::string error = "";
+		};
+
+		inline bool IsSpace(char _c)
+		{
+			return _c == ' ' || _c == '\t';
+		}
+
+		inline bool IsDigit(char _c)
+		{
+			return _c >= '0' && _c <= '9';
+		}
+
+		inline bool IsLineEnd(char _c)
+		{
+			return _c == '\n' || _c == '\r' || _c == '#';
+		}
+
+		inline const char *SkipSpaces(const char *_p, const char *_end)
+		{
+			while (_p < _end && IsSpace(*_p))
+				_p++;
+			return _p;
+		}
+
+		// returns the first character of the next line
+		inline const char *SkipLine(const char *_p, const char *_end)
+		{
+			const char *newline = (const char *)memchr(_p, '\n', _end - _p);
+			return (newline == nullptr) ? _end : newline + 1;
+		}
+
+		bool ParseInt(const char *&_p, const char *_end, int &_value)
+		{
+			const char *p = _p;
+			bool negative = false;
+
+			if (p < _end && (*p == '-' || *p == '+'))
+				negative = (*p++ == '-');
+
+			if (p == _end || !IsDigit(*p))
+				return false;
+
+			int value = 0;
+			while (p < _end && IsDigit(*p))
+				value = value * 10 + (*p++ - '0');
+
+			_value = negative ? -value : value;
+			_p = p;
+			return true;
+		}
+
+		// decimal and exponent notation, up to 19 significant digits are kept which is more than a float holds
+		bool ParseFloat(const char *&_p, const char *_end, float &_value)
+		{
+			static const double POWERS_OF_TEN[] = {
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+			const char *p = _p;
+			bool negative = false;
+
+			if (p < _end && (*p == '-' || *p == '+'))
+				negative = (*p++ == '-');
+
+			uint64_t mantissa = 0;
+			int digits = 0;
+			int exponent = 0;
+			bool any = false;
+
+			for (; p < _end && IsDigit(*p); p++)
+			{
+				any = true;
+				if (digits < 19)
+				{
+					mantissa = mantissa * 10 + (*p - '0');
+					digits += (mantissa != 0);
+				}
+				else
+				{
+					exponent++;
+				}
+			}
+
+			if (p < _end && *p == '.')
+			{
+				for (p++; p < _end && IsDigit(*p); p++)
+				{
+					any = true;
+					if (digits < 19)
+					{
+						mantissa = mantissa * 10 + (*p - '0');
+						digits += (mantissa != 0);
+						exponent--;
+					}
+				}
+			}
+
+			if (!any)
+				return false;
+
+			if (p < _end && (*p == 'e' || *p == 'E'))
+			{
+				const char *e = p + 1;
+				int power = 0;
+				if (ParseInt(e, _end, power))
+				{
+					exponent += power;
+					p = e;
+				}
+			}
+
+			double value = (double)mantissa;
+
+			if (exponent < 0)
+				value = (exponent >= -22) ? value / POWERS_OF_TEN[-exponent] : value * std::pow(10.0, exponent);
+			else if (exponent > 0)
+				value = (exponent <= 22) ? value * POWERS_OF_TEN[exponent] : value * std::pow(10.0, exponent);
+
+			_value = (float)(negative ? -value : value);
+			_p = p;
+			return true;
+		}
+
+		// a component that is missing or not a number stays 0 with the ones after it, like the v of "vt u"
+		inline void ParseFloats(const char *_p, const char *_end, float *_values, int _count)
+		{
+			for (int i = 0; i < _count; i++)
+			{
+				_p = SkipSpaces(_p, _end);
+				if (!ParseFloat(_p, _end, _values[i]))
+					return;
+			}
+		}
+
+		// positive indices are already global, negative ones are kept relative to this chunk
+		inline int ResolveIndex(int _index, size_t _count, uint8_t _flag, uint8_t &_relative)
+		{
+			if (_index > 0)
+				return _index;
+
+			_relative |= _flag;
+			return (int)_count + _index;
+		}
+
+		void ParseObjChunk(ObjChunk &_chunk)
+		{
+			const char *p = _chunk.begin;
+			const char *end = _chunk.end;
+
+			while (p < end)
+			{
+				p = SkipSpaces(p, end);
+
+				if (p + 1 < end && p[0] == 'v' && IsSpace(p[1]))
+				{
+					glm::vec3 position(0.0f);
+					ParseFloats(p + 2, end, &position[0], 3);
+					_chunk.positions.push_back(position);
+				}
+				else if (p + 2 < end && p[0] == 'v' && p[1] == 't' && IsSpace(p[2]))
+				{
+					glm::vec2 uv(0.0f);
+					ParseFloats(p + 3, end, &uv[0], 2);
+					uv.y = -uv.y; // matches the old loader, the V coordinate is inverted
+					_chunk.uvs.push_back(uv);
+				}
+				else if (p + 2 < end && p[0] == 'v' && p[1] == 'n' && IsSpace(p[2]))
+				{
+					glm::vec3 normal(0.0f);
+					ParseFloats(p + 3, end, &normal[0], 3);
+					_chunk.normals.push_back(normal);
+				}
+				else if (p + 1 < end && p[0] == 'f' && IsSpace(p[1]))
+				{
+					// v, v/vt, v//vn or v/vt/vn corners, any number of them
+					unsigned int cornerCount = 0;
+					p++;
+
+					while (true)
+					{
+						p = SkipSpaces(p, end);
+						if (p >= end || IsLineEnd(*p))
+							break;
+
+						ObjCorner corner;
+						int index = 0;
+
+						if (!ParseInt(p, end, index) || index == 0)
+						{
+							_chunk.error = "bad face index";
+							return;
+						}
+						corner.position = ResolveIndex(index, _chunk.positions.size(), OBJ_RELATIVE_POSITION, corner.relative);
+
+						if (p < end && *p == '/')
+						{
+							p++;
+							if (ParseInt(p, end, index) && index != 0)
+								corner.uv = ResolveIndex(index, _chunk.uvs.size(), OBJ_RELATIVE_UV, corner.relative);
+
+							if (p < end && *p == '/')
+							{
+								p++;
+								if (ParseInt(p, end, index) && index != 0)
+									corner.normal = ResolveIndex(index, _chunk.normals.size(), OBJ_RELATIVE_NORMAL, corner.relative);
+							}
+						}
+
+						if (p < end && !IsSpace(*p) && !IsLineEnd(*p))
+						{
+							_chunk.error = "bad face corner";
+							return;
+						}
+
+						_chunk.corners.push_back(corner);
+						cornerCount++;
+					}
+
+					if (cornerCount < 3)
+					{
+						_chunk.error = "face with less than 3 corners";
+						return;
+					}
+
+					_chunk.faceSizes.push_back(cornerCount);
+					_chunk.triangles += cornerCount - 2;
+				}
+
+				p = SkipLine(p, end);
+			}
+		}
+
+		// resolves one stream of a corner into a 0 based index, -1 when the corner leaves the stream out
+		// returns false when the index is outside of the stream
+		inline bool GlobalIndex(const ObjCorner &_corner, int _value, uint8_t _flag, size_t _first, size_t _count, long long &_index)
+		{
+			if ((_corner.relative & _flag) == 0 && _value == 0)
+			{
+				_index = -1;
+				return true;
+			}
+
+			_index = (_corner.relative & _flag) ? (long long)_first + _value : (long long)_value - 1;
+			return _index >= 0 && _index < (long long)_count;
+		}
+
+		// turns the chunk's faces into triangles fanned from their first corner, written from triangle firstTriangle on
+		void ExpandObjChunk(ObjChunk &_chunk,
+							const std::vector<glm::vec3> &_positions,
+							const std::vector<glm::vec2> &_uvs,
+							const std::vector<glm::vec3> &_normals,
+							glm::vec3 *_outPositions, glm::vec2 *_outUVs, glm::vec3 *_outNormals)
+		{
+			size_t corner = 0;
+			size_t vertex = _chunk.firstTriangle * 3;
+
+			for (unsigned int faceSize : _chunk.faceSizes)
+			{
+				const ObjCorner *face = &_chunk.corners[corner];
+				corner += faceSize;
+
+				for (unsigned int t = 0; t + 2 < faceSize; t++)
+				{
+					const ObjCorner *triangle[3] = {&face[0], &face[t + 1], &face[t + 2]};
+					bool missingNormal = false;
+
+					for (int i = 0; i < 3; i++)
+					{
+						long long position, uv, normal;
+
+						if (!GlobalIndex(*triangle[i], triangle[i]->position, OBJ_RELATIVE_POSITION, _chunk.firstPosition, _positions.size(), position) ||
+							!GlobalIndex(*triangle[i], triangle[i]->uv, OBJ_RELATIVE_UV, _chunk.firstUV, _uvs.size(), uv) ||
+							!GlobalIndex(*triangle[i], triangle[i]->normal, OBJ_RELATIVE_NORMAL, _chunk.firstNormal, _normals.size(), normal) ||
+							position < 0)
+						{
+							_chunk.error = "face index out of range";
+							return;
+						}
+
+						_outPositions[vertex + i] = _positions[position];
+						_outUVs[vertex + i] = (uv < 0) ? glm::vec2(0.0f) : _uvs[uv];
+
+						if (normal < 0)
+							missingNormal = true;
+						else
+							_outNormals[vertex + i] = _normals[normal];
+					}
+
+					// faces without normals get a flat one
+					if (missingNormal)
+					{
+						glm::vec3 faceNormal = glm::cross(_outPositions[vertex + 1] - _outPositions[vertex], _outPositions[vertex + 2] - _outPositions[vertex]);
+						float length = glm::length(faceNormal);
+						faceNormal = (length > 0.0f) ? faceNormal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+
+						for (int i = 0; i < 3; i++)
+							_outNormals[vertex + i] = faceNormal;
+					}
+
+					vertex += 3;
+				}
+			}
+		}
+
+		// calls _function(0) to _function(_count - 1), the calling thread runs index 0
+		template <typename Function>
+		void RunOnThreads(unsigned int _count, Function _function)
+		{
+			std::vector<std::thread> threads;
+			for (unsigned int i = 1; i < _count; i++)
+				threads.emplace_back(_function, i);
+
+			_function(0);
+
+			for (std::thread &thread : threads)
+				thread.join();
+		}
 	}
 
-	GLTexture LoadImageGL(std::string _path, int _sourceFormat, int _format, bool _wrap)
+	namespace
 	{
-		GLTexture texture;
-		int nrChannels;
+		// pixels and mips loaded on any thread, uploaded on the gl thread
+		struct DecodedImage
+		{
+			TextureData texture;
+			std::string error = "";
+		};
 
-		glGenTextures(1, &texture.id);
-		glBindTexture(GL_TEXTURE_2D, texture.id);
+		// _channels 0 keeps the channels of the file
+		void DecodeImage(const std::string &_path, int _channels, bool _flip, DecodedImage &_image)
+		{
+			if (!LoadTextureData(_path, _channels, _flip, _image.texture, GetConfig().textureCache))
+				_image.error = "Failed to load texture " + _path;
+		}
+
+		// unmaps the .ctex or frees the decoded pixels once they are on the gpu
+		void FreeImage(DecodedImage &_image)
+		{
+			_image.texture.file.Close();
+			std::vector<uint8_t>().swap(_image.texture.parsedPixels);
+		}
+
+		// averages the source pixels under each new pixel, which is nearest neighbour when scaling up, only level 0 is kept
+		void ResizeImage(DecodedImage &_image, int _width, int _height)
+		{
+			TextureData &texture = _image.texture;
+			int channels = texture.channels;
+			const uint8_t *source = texture.levels[0].pixels;
+			std::vector<uint8_t> pixels((size_t)_width * _height * channels);
+
+			for (int y = 0; y < _height; y++)
+			{
+				int y0 = (int)((int64_t)y * texture.height / _height);
+				int y1 = std::max(y0 + 1, (int)((int64_t)(y + 1) * texture.height / _height));
+
+				for (int x = 0; x < _width; x++)
+				{
+					int x0 = (int)((int64_t)x * texture.width / _width);
+					int x1 = std::max(x0 + 1, (int)((int64_t)(x + 1) * texture.width / _width));
+					uint32_t sum[4] = {};
+
+					for (int sy = y0; sy < y1; sy++)
+						for (int sx = x0; sx < x1; sx++)
+							for (int c = 0; c < channels; c++)
+								sum[c] += source[((size_t)sy * texture.width + sx) * channels + c];
+
+					uint32_t count = (uint32_t)((y1 - y0) * (x1 - x0));
+					for (int c = 0; c < channels; c++)
+						pixels[((size_t)y * _width + x) * channels + c] = (uint8_t)((sum[c] + count / 2) / count);
+				}
+			}
 
-		stbi_set_flip_vertically_on_load(true);
-		SDL_RWops *file = SDL_RWFromFile(_path.c_str(), "rb");
+			texture.parsedPixels.swap(pixels);
+			texture.file.Close();
+			texture.width = _width;
+			texture.height = _height;
+			texture.levelCount = 1;
+			texture.levels[0] = {texture.parsedPixels.data(), _width, _height};
+		}
 
-		if (file != NULL)
+		// creates the texture even when decoding failed so callers always get a valid id
+		GLTexture UploadImage(DecodedImage &_image, int _sourceFormat, int _format, bool _wrap)
 		{
-			int imageDataLength{static_cast<int>(SDL_RWsize(file))};
-			void *imageData{SDL_LoadFile_RW(file, nullptr, 1)};
+			const TextureData &image = _image.texture;
+
+			GLTexture texture;
+			texture.width = image.width;
+			texture.height = image.height;
+
+			glGenTextures(1, &texture.id);
+			glBindTexture(GL_TEXTURE_2D, texture.id);
 
-			// convert to stbi thing
-			stbi_uc *data = stbi_load_from_memory(static_cast<stbi_uc *>(imageData), imageDataLength, &texture.width, &texture.height, &nrChannels, 4);
-			if (data)
+			// the levels come with the image, so no glGenerateMipmap
+			if (image.levelCount > 0)
 			{
-				glTexImage2D(GL_TEXTURE_2D, 0, _sourceFormat, texture.width, texture.height, 0, _format, GL_UNSIGNED_BYTE, data);
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+				for (int i = 0; i < image.levelCount; i++)
+					glTexImage2D(GL_TEXTURE_2D, i, _sourceFormat, image.levels[i].width, image.levels[i].height, 0, _format, GL_UNSIGNED_BYTE, image.levels[i].pixels);
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.levelCount - 1);
 			}
 			else
 			{
-				std::cout << "Failed to load texture " << _path << std::endl;
+				Canis::Error(_image.error);
 			}
-			stbi_image_free(data);
-			// SDL_RWclose(file);
-			// SDL_free(imageData);
+
+			FreeImage(_image);
+
+			if (_wrap)
+			{
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			}
+			else
+			{
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			}
+			// Problem for future ERIC
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST); // GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);				 // GL_LINEAR);
+
+			glBindTexture(GL_TEXTURE_2D, 0);
+
+			return texture;
 		}
-		else
+	}
+
+	GLTexture LoadImageGL(std::string _path, bool _wrap)
+	{
+		return LoadImageGL(_path, GL_RGBA, GL_RGBA, _wrap);
+	}
+
+	GLTexture LoadImageGL(std::string _path, int _sourceFormat, int _format, bool _wrap)
+	{
+		DecodedImage image;
+		DecodeImage(_path, 4, true, image);
+		return UploadImage(image, _sourceFormat, _format, _wrap);
+	}
+
+	std::vector<GLTexture> LoadImagesGL(const std::vector<TextureRequest> &_requests)
+	{
+		std::vector<DecodedImage> images(_requests.size());
+		std::vector<std::future<void>> decoded;
+		decoded.reserve(_requests.size());
+
+		for (size_t i = 0; i < _requests.size(); i++)
 		{
-			Canis::Error("Failed to open file at path : " + _path);
+			DecodedImage *image = &images[i];
+			const std::string *path = &_requests[i].path;
+			decoded.push_back(GetThreadPool().Submit([image, path]() { DecodeImage(*path, 4, true, *image); }));
 		}
 
-		if (_wrap)
+		// uploads in request order while the workers decode the rest
+		std::vector<GLTexture> textures(_requests.size());
+		for (size_t i = 0; i < _requests.size(); i++)
 		{
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			decoded[i].wait();
+
+			int sourceFormat = (_requests[i].sourceFormat != 0) ? _requests[i].sourceFormat : GL_RGBA;
+			int format = (_requests[i].format != 0) ? _requests[i].format : GL_RGBA;
+			textures[i] = UploadImage(images[i], sourceFormat, format, _requests[i].wrap);
 		}
-		else
+
+		return textures;
+	}
+
+	GLTexture LoadImageArrayGL(const std::vector<std::string> &_paths, bool _wrap)
+	{
+		std::vector<DecodedImage> images(_paths.size());
+		std::vector<std::future<void>> decoded;
+		decoded.reserve(_paths.size());
+
+		for (size_t i = 0; i < _paths.size(); i++)
 		{
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			DecodedImage *image = &images[i];
+			const std::string *path = &_paths[i];
+			// layers of another size are scaled on the pool too, a large image would otherwise cost every layer its size
+			decoded.push_back(GetThreadPool().Submit([image, path]() {
+				DecodeImage(*path, 4, true, *image);
+
+				const TextureData &texture = image->texture;
+				if (texture.levelCount > 0 && (texture.width != TEXTURE_ARRAY_SIZE || texture.height != TEXTURE_ARRAY_SIZE))
+					ResizeImage(*image, TEXTURE_ARRAY_SIZE, TEXTURE_ARRAY_SIZE);
+			}));
 		}
-		// Problem for future ERIC
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST); // GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);				 // GL_LINEAR);
 
-		glGenerateMipmap(GL_TEXTURE_2D);
+		GLTexture texture;
+		texture.width = TEXTURE_ARRAY_SIZE;
+		texture.height = TEXTURE_ARRAY_SIZE;
+		texture.layers = _paths.size();
 
-		glBindTexture(GL_TEXTURE_2D, 0);
+		int levelCount = 1;
+		while (levelCount < MAX_TEXTURE_LEVELS && (texture.width >> levelCount > 0 || texture.height >> levelCount > 0))
+			levelCount++;
 
-		stbi_set_flip_vertically_on_load(true);
+		glGenTextures(1, &texture.id);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, texture.id);
+		for (int level = 0; level < levelCount; level++)
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA, std::max(1, texture.width >> level), std::max(1, texture.height >> level), texture.layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		// layers at the full size bring their own mips, only resized layers leave the chain to glGenerateMipmap
+		bool generateMipmap = false;
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		for (size_t i = 0; i < _paths.size(); i++)
+		{
+			decoded[i].wait();
+			TextureData &image = images[i].texture;
+
+			if (image.levelCount == 0)
+			{
+				Error(images[i].error);
+				continue;
+			}
+
+			if (image.levelCount != levelCount)
+				generateMipmap = true;
+
+			for (int level = 0; level < image.levelCount; level++)
+				glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, i, image.levels[level].width, image.levels[level].height, 1, GL_RGBA, GL_UNSIGNED_BYTE, image.levels[level].pixels);
+
+			FreeImage(images[i]);
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		int wrap = _wrap ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, wrap);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, wrap);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+		if (generateMipmap)
+			glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
 
 		return texture;
 	}
 
 	unsigned int LoadImageToCubemap(std::vector<std::string> _faces, int _sourceFormat)
 	{
-		stbi_set_flip_vertically_on_load(false);
+		// every face decodes on the pool, only the uploads wait for each other
+		std::vector<DecodedImage> images(_faces.size());
+		std::vector<std::future<void>> decoded;
+
+		for (size_t i = 0; i < _faces.size(); i++)
+		{
+			DecodedImage *image = &images[i];
+			const std::string *path = &_faces[i];
+			decoded.push_back(GetThreadPool().Submit([image, path]() { DecodeImage(*path, 0, false, *image); }));
+		}
 
 		unsigned int textureID;
 		glGenTextures(1, &textureID);
 		glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
 
-		int width, height, nrChannels;
-
 		for (unsigned int i = 0; i < _faces.size(); i++)
 		{
-			unsigned char *data = stbi_load(_faces[i].c_str(), &width, &height, &nrChannels, 0);
-			if (data)
+			decoded[i].wait();
+
+			// the skybox samples without mips, only level 0 is uploaded
+			const TextureData &image = images[i].texture;
+			if (image.levelCount > 0)
 			{
-				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, _sourceFormat, width, height, 0, _sourceFormat, GL_UNSIGNED_BYTE, data);
-				stbi_image_free(data);
+				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, _sourceFormat, image.width, image.height, 0, _sourceFormat, GL_UNSIGNED_BYTE, image.levels[0].pixels);
+				FreeImage(images[i]);
 			}
 			else
 			{
 				Error("Cubemap texture failed to load at path: " + _faces[i]);
-				stbi_image_free(data);
 			}
 		}
 
@@ -103,12 +637,111 @@ namespace Canis
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 
-		stbi_set_flip_vertically_on_load(true);
-
 		return textureID;
 	}
-	
+
 	bool LoadOBJ(
+		std::string _path,
+		std::vector<glm::vec3> &_positions,
+		std::vector<glm::vec2> &_uvs,
+		std::vector<glm::vec3> &_normals,
+		unsigned int _threads)
+	{
+		VirtualFile file;
+		if (!file.Open(_path))
+		{
+			Error("Can not open model: " + _path);
+			return false;
+		}
+
+		const char *data = file.GetData();
+		const char *end = data + file.GetSize();
+
+		if (_threads == 0)
+			_threads = std::max(1u, std::thread::hardware_concurrency());
+		_threads = (unsigned int)std::max<size_t>(1, std::min<size_t>(_threads, file.GetSize() / OBJ_MIN_BYTES_PER_THREAD));
+
+		// every thread gets a range of whole lines
+		std::vector<ObjChunk> chunks(_threads);
+		const char *begin = data;
+		for (unsigned int i = 0; i < _threads; i++)
+		{
+			chunks[i].begin = begin;
+			chunks[i].end = (i + 1 == _threads) ? end : SkipLine(std::max(begin, data + file.GetSize() * (i + 1) / _threads), end);
+			begin = chunks[i].end;
+		}
+
+		RunOnThreads(_threads, [&](unsigned int _index) { ParseObjChunk(chunks[_index]); });
+
+		size_t positionCount = 0, uvCount = 0, normalCount = 0, triangleCount = 0;
+		for (ObjChunk &chunk : chunks)
+		{
+			if (!chunk.error.empty())
+			{
+				Error("Failed to parse model " + _path + ": " + chunk.error);
+				return false;
+			}
+
+			chunk.firstPosition = positionCount;
+			chunk.firstUV = uvCount;
+			chunk.firstNormal = normalCount;
+			chunk.firstTriangle = triangleCount;
+			positionCount += chunk.positions.size();
+			uvCount += chunk.uvs.size();
+			normalCount += chunk.normals.size();
+			triangleCount += chunk.triangles;
+		}
+
+		std::vector<glm::vec3> positions;
+		std::vector<glm::vec2> uvs;
+		std::vector<glm::vec3> normals;
+
+		if (chunks.size() == 1)
+		{
+			positions.swap(chunks[0].positions);
+			uvs.swap(chunks[0].uvs);
+			normals.swap(chunks[0].normals);
+		}
+		else
+		{
+			positions.reserve(positionCount);
+			uvs.reserve(uvCount);
+			normals.reserve(normalCount);
+
+			for (ObjChunk &chunk : chunks)
+			{
+				positions.insert(positions.end(), chunk.positions.begin(), chunk.positions.end());
+				uvs.insert(uvs.end(), chunk.uvs.begin(), chunk.uvs.end());
+				normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+			}
+		}
+
+		// triangles are appended after whatever the vectors already hold
+		size_t first = _positions.size();
+		_positions.resize(first + triangleCount * 3);
+		_uvs.resize(first + triangleCount * 3);
+		_normals.resize(first + triangleCount * 3);
+
+		RunOnThreads(_threads, [&](unsigned int _index) {
+			ExpandObjChunk(chunks[_index], positions, uvs, normals, &_positions[first], &_uvs[first], &_normals[first]);
+		});
+
+		for (ObjChunk &chunk : chunks)
+		{
+			if (!chunk.error.empty())
+			{
+				Error("Failed to parse model " + _path + ": " + chunk.error);
+				_positions.resize(first);
+				_uvs.resize(first);
+				_normals.resize(first);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool LoadOBJScanf(
 		std::string _path,
 		std::vector<glm::vec3> &_positions,
 		std::vector<glm::vec2> &_uvs,
@@ -1,21 +1,50 @@
-#pragma once
-#include <string>
-#include <vector>
-#include <glm/glm.hpp>
-#include "Data/GLTexture.hpp"
-
-namespace Canis
-{
-    extern GLTexture LoadImageGL(std::string _path, bool _wrap);
-
-    extern GLTexture LoadImageGL(std::string _path, int _sourceFormat, int _format, bool _wrap);
-
-    extern unsigned int LoadImageToCubemap(std::vector<std::string> _faces, int _sourceFormat);
-
-    extern bool LoadOBJ(std::string _path,
-                        std::vector<glm::vec3> &_positions,
-                        std::vector<glm::vec2> &_uvs,
-                        std::vector<glm::vec3> &_normals);
-
-    extern std::vector<float> LoadOBJ(std::string _path);
+#pragma once
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Data/GLTexture.hpp"
+
+namespace Canis
+{
+    extern GLTexture LoadImageGL(std::string _path, bool _wrap);
+
+    extern GLTexture LoadImageGL(std::string _path, int _sourceFormat, int _format, bool _wrap);
+
+    // one texture of a LoadImagesGL batch, formats left at 0 use GL_RGBA like LoadImageGL(_path, _wrap)
+    struct TextureRequest
+    {
+        std::string path;
+        bool wrap = true;
+        int sourceFormat = 0;
+        int format = 0;
+    };
+
+    // decodes every image on the thread pool and uploads them on the calling gl thread as they finish
+    // the textures come back in request order
+    extern std::vector<GLTexture> LoadImagesGL(const std::vector<TextureRequest> &_requests);
+
+    // every layer of a LoadImageArrayGL texture is this size, the block textures are drawn at it
+    const int TEXTURE_ARRAY_SIZE = 16;
+
+    // loads every image as one layer of a GL_TEXTURE_2D_ARRAY, images of another size are scaled to TEXTURE_ARRAY_SIZE
+    extern GLTexture LoadImageArrayGL(const std::vector<std::string> &_paths, bool _wrap);
+
+    // the six faces are decoded in parallel
+    extern unsigned int LoadImageToCubemap(std::vector<std::string> _faces, int _sourceFormat);
+
+    // memory mapped parser, faces can have any number of corners, negative indices and no uv or normal
+    // _threads 0 uses every core, files too small to be worth splitting are parsed on one thread
+    extern bool LoadOBJ(std::string _path,
+                        std::vector<glm::vec3> &_positions,
+                        std::vector<glm::vec2> &_uvs,
+                        std::vector<glm::vec3> &_normals,
+                        unsigned int _threads = 0);
+
+    // the original fscanf parser, only v/vt/vn triangles, kept to benchmark LoadOBJ against
+    extern bool LoadOBJScanf(std::string _path,
+                             std::vector<glm::vec3> &_positions,
+                             std::vector<glm::vec2> &_uvs,
+                             std::vector<glm::vec3> &_normals);
+
+    extern std::vector<float> LoadOBJ(std::string _path);
 } // end of Canis namespace
\ No newline at end of file
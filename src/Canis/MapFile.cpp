@@ -0,0 +1,221 @@
+#include "MapFile.hpp"
+#include "AssetPack.hpp"
+#include "Debug.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace Canis
+{
+    namespace
+    {
+        const char MAP_MAGIC[4] = {'C', 'M', 'A', 'P'};
+        // blocks along each axis, keeps a bad header from sizing the grid past what the int indexing can reach
+        const uint32_t MAX_MAP_SIZE = 4096;
+
+        bool IsUniform(const uint8_t *_blocks)
+        {
+            for (int i = 1; i < VoxelGrid::CHUNK_VOLUME; i++)
+                if (_blocks[i] != _blocks[0])
+                    return false;
+            return true;
+        }
+    }
+
+    bool LoadMapFile(const std::string &_path, VoxelGrid &_grid)
+    {
+        VirtualFile file;
+        if (!file.Open(_path))
+        {
+            Error("Map not found at: " + _path);
+            return false;
+        }
+
+        const MapFileHeader *header = (const MapFileHeader *)file.GetData();
+        size_t size = file.GetSize();
+
+        if (size < sizeof(MapFileHeader) || memcmp(header->magic, MAP_MAGIC, 4) != 0 || header->version != MAP_FILE_VERSION ||
+            header->chunkSize != CHUNK_SIZE || header->paletteSize == 0 || header->paletteSize > 256)
+        {
+            Error("Map " + _path + " is not a version " + std::to_string(MAP_FILE_VERSION) + " .cmap");
+            return false;
+        }
+
+        if (header->sizeX == 0 || header->sizeY == 0 || header->sizeZ == 0 ||
+            header->sizeX > MAX_MAP_SIZE || header->sizeY > MAX_MAP_SIZE || header->sizeZ > MAX_MAP_SIZE)
+        {
+            Error("Map " + _path + " has a bad size of " + std::to_string(header->sizeX) + ", " +
+                  std::to_string(header->sizeY) + ", " + std::to_string(header->sizeZ));
+            return false;
+        }
+
+        // the sizes are bounded so the table fits in 64 bits, the offsets are checked against size before adding
+        uint64_t tableSize = (uint64_t)((header->sizeX + CHUNK_SIZE - 1) / CHUNK_SIZE) *
+                             ((header->sizeY + CHUNK_SIZE - 1) / CHUNK_SIZE) *
+                             ((header->sizeZ + CHUNK_SIZE - 1) / CHUNK_SIZE) * sizeof(MapFileChunk);
+
+        if (header->chunkTableOffset > size || tableSize > size - header->chunkTableOffset || header->payloadOffset > size)
+        {
+            Error("Map " + _path + " is cut short");
+            return false;
+        }
+
+        _grid.Resize((int)header->sizeX, (int)header->sizeY, (int)header->sizeZ);
+        glm::ivec3 chunkCount = _grid.GetChunkCount();
+
+        const MapFileChunk *table = (const MapFileChunk *)(file.GetData() + header->chunkTableOffset);
+        const uint8_t *payload = (const uint8_t *)file.GetData() + header->payloadOffset;
+        size_t payloadChunks = (size - header->payloadOffset) / VoxelGrid::CHUNK_VOLUME;
+
+        // palette indices past the palette read as air
+        uint8_t palette[256] = {};
+        memcpy(palette, header->palette, header->paletteSize);
+
+        size_t chunk = 0;
+        for (int cy = 0; cy < chunkCount.y; cy++)
+        {
+            for (int cx = 0; cx < chunkCount.x; cx++)
+            {
+                for (int cz = 0; cz < chunkCount.z; cz++, chunk++)
+                {
+                    uint8_t *blocks = _grid.GetChunkData(glm::ivec3(cx, cy, cz));
+
+                    if (table[chunk].payload == MAP_CHUNK_UNIFORM)
+                    {
+                        memset(blocks, palette[table[chunk].block & 0xff], VoxelGrid::CHUNK_VOLUME);
+                        continue;
+                    }
+
+                    if (table[chunk].payload >= payloadChunks)
+                    {
+                        Error("Map " + _path + " is cut short");
+                        _grid.Clear();
+                        return false;
+                    }
+
+                    const uint8_t *indices = payload + (size_t)table[chunk].payload * VoxelGrid::CHUNK_VOLUME;
+                    for (int i = 0; i < VoxelGrid::CHUNK_VOLUME; i++)
+                        blocks[i] = palette[indices[i]];
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool SaveMapFile(const std::string &_path, const VoxelGrid &_grid, const std::string &_sourcePath)
+    {
+        glm::ivec3 chunkCount = _grid.GetChunkCount();
+        size_t chunkTotal = (size_t)chunkCount.x * chunkCount.y * chunkCount.z;
+
+        // the palette lists the ids in use from low to high
+        bool used[256] = {};
+        for (int cy = 0; cy < chunkCount.y; cy++)
+            for (int cx = 0; cx < chunkCount.x; cx++)
+                for (int cz = 0; cz < chunkCount.z; cz++)
+                {
+                    const uint8_t *blocks = _grid.GetChunkData(glm::ivec3(cx, cy, cz));
+                    for (int i = 0; i < VoxelGrid::CHUNK_VOLUME; i++)
+                        used[blocks[i]] = true;
+                }
+
+        MapFileHeader header = {};
+        memcpy(header.magic, MAP_MAGIC, 4);
+        header.version = MAP_FILE_VERSION;
+        GetFileStamp(_sourcePath, header.sourceSize, header.sourceTime);
+        header.sizeX = _grid.GetSizeX();
+        header.sizeY = _grid.GetSizeY();
+        header.sizeZ = _grid.GetSizeZ();
+        header.chunkSize = CHUNK_SIZE;
+
+        uint8_t toPalette[256] = {};
+        for (int id = 0; id < 256; id++)
+        {
+            if (!used[id])
+                continue;
+
+            toPalette[id] = header.paletteSize;
+            header.palette[header.paletteSize++] = id;
+        }
+
+        // an empty grid still gets air so the palette is never empty
+        if (header.paletteSize == 0)
+            header.paletteSize = 1;
+
+        std::vector<MapFileChunk> table(chunkTotal);
+        std::vector<uint8_t> payload;
+        uint32_t payloadChunks = 0;
+
+        size_t chunk = 0;
+        for (int cy = 0; cy < chunkCount.y; cy++)
+        {
+            for (int cx = 0; cx < chunkCount.x; cx++)
+            {
+                for (int cz = 0; cz < chunkCount.z; cz++, chunk++)
+                {
+                    const uint8_t *blocks = _grid.GetChunkData(glm::ivec3(cx, cy, cz));
+
+                    if (IsUniform(blocks))
+                    {
+                        table[chunk].payload = MAP_CHUNK_UNIFORM;
+                        table[chunk].block = toPalette[blocks[0]];
+                        continue;
+                    }
+
+                    table[chunk].payload = payloadChunks++;
+                    size_t start = payload.size();
+                    payload.resize(start + VoxelGrid::CHUNK_VOLUME);
+                    for (int i = 0; i < VoxelGrid::CHUNK_VOLUME; i++)
+                        payload[start + i] = toPalette[blocks[i]];
+                }
+            }
+        }
+
+        header.chunkTableOffset = AlignBlob(sizeof(MapFileHeader));
+        header.payloadOffset = AlignBlob(header.chunkTableOffset + table.size() * sizeof(MapFileChunk));
+
+        auto write = [&](std::ostream &_file)
+        {
+            _file.write((const char *)&header, sizeof(header));
+            WritePadding(_file, header.chunkTableOffset);
+            _file.write((const char *)table.data(), table.size() * sizeof(MapFileChunk));
+            WritePadding(_file, header.payloadOffset);
+            _file.write((const char *)payload.data(), payload.size());
+        };
+
+        if (!WriteFileAtomically(_path, write))
+        {
+            Error("Can not write map " + _path);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool IsMapFileCurrent(const std::string &_path, const std::string &_textPath)
+    {
+        VirtualFile file;
+        if (!file.Open(_path))
+            return false;
+
+        const MapFileHeader *header = (const MapFileHeader *)file.GetData();
+        if (file.GetSize() < sizeof(MapFileHeader) || memcmp(header->magic, MAP_MAGIC, 4) != 0 || header->version != MAP_FILE_VERSION)
+            return false;
+
+        uint64_t sourceSize = 0;
+        int64_t sourceTime = 0;
+        if (!GetFileStamp(_textPath, sourceSize, sourceTime))
+            return true;
+
+        return sourceSize == header->sourceSize && sourceTime == header->sourceTime;
+    }
+
+    bool ConvertMap(const std::string &_textPath, const std::string &_binaryPath)
+    {
+        VoxelGrid grid;
+        if (!LoadMap(_textPath, grid))
+            return false;
+
+        return SaveMapFile(_binaryPath, grid, _textPath);
+    }
+} // end of Canis namespace
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "VoxelGrid.hpp"
+
+namespace Canis
+{
+    // bump when the layout changes, older files are refused
+    const uint32_t MAP_FILE_VERSION = 2;
+    // a chunk table entry with this payload is filled with one block
+    const uint32_t MAP_CHUNK_UNIFORM = 0xffffffff;
+
+    // start of a .cmap file, the chunk table and the payload follow at their offsets
+    struct MapFileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceSize; // size and write time of the text .map the file was converted from
+        int64_t sourceTime;
+        uint32_t sizeX;
+        uint32_t sizeY;
+        uint32_t sizeZ;
+        uint32_t chunkSize; // CHUNK_SIZE of the writer, the chunks are in VoxelGrid's order and layout
+        uint32_t paletteSize;
+        uint8_t palette[256]; // block id of every palette index
+        uint64_t chunkTableOffset;
+        uint64_t payloadOffset;
+    };
+
+    // one per chunk
+    struct MapFileChunk
+    {
+        uint32_t payload; // the chunk's CHUNK_VOLUME palette indices start at payloadOffset + payload * CHUNK_VOLUME
+        uint32_t block;   // palette index of every block when payload is MAP_CHUNK_UNIFORM
+    };
+
+    // maps the .cmap once and fills the grid chunk by chunk
+    extern bool LoadMapFile(const std::string &_path, VoxelGrid &_grid);
+
+    // _sourcePath is the text .map the grid came from, its stamp goes in the header
+    extern bool SaveMapFile(const std::string &_path, const VoxelGrid &_grid, const std::string &_sourcePath);
+
+    // false when the .cmap is missing, not the current version or made from a different _textPath than the one on disk
+    // a .cmap without its text map is still current
+    extern bool IsMapFileCurrent(const std::string &_path, const std::string &_textPath);
+
+    // loads a text .map with LoadMap and writes it as a .cmap
+    extern bool ConvertMap(const std::string &_textPath, const std::string &_binaryPath);
+} // end of Canis namespace
@@ -0,0 +1,161 @@
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Canis
+{
+#ifdef _WIN32
+    bool MappedFile::Open(const std::string &_path)
+    {
+        Close();
+
+        HANDLE file = CreateFileA(_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        m_file = file;
+        m_size = (size_t)size.QuadPart;
+        m_open = true;
+
+        // windows can not map an empty file
+        if (m_size == 0)
+            return true;
+
+        m_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (m_mapping != NULL)
+            m_data = (const char *)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+
+        if (m_data == nullptr)
+        {
+            Close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data != nullptr)
+            UnmapViewOfFile(m_data);
+        if (m_mapping != nullptr)
+            CloseHandle(m_mapping);
+        if (m_file != nullptr)
+            CloseHandle(m_file);
+
+        m_data = nullptr;
+        m_mapping = nullptr;
+        m_file = nullptr;
+        m_size = 0;
+        m_open = false;
+    }
+#else
+    bool MappedFile::Open(const std::string &_path)
+    {
+        Close();
+
+        int file = open(_path.c_str(), O_RDONLY);
+        if (file < 0)
+            return false;
+
+        struct stat info;
+        if (fstat(file, &info) != 0)
+        {
+            close(file);
+            return false;
+        }
+
+        m_size = (size_t)info.st_size;
+        m_open = true;
+
+        if (m_size > 0)
+        {
+            void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+            if (data == MAP_FAILED)
+            {
+                close(file);
+                m_size = 0;
+                m_open = false;
+                return false;
+            }
+
+            // the loaders read front to back
+            madvise(data, m_size, MADV_SEQUENTIAL);
+            m_data = (const char *)data;
+        }
+
+        // the mapping stays valid after the descriptor is closed
+        close(file);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (m_data != nullptr)
+            munmap((void *)m_data, m_size);
+
+        m_data = nullptr;
+        m_size = 0;
+        m_open = false;
+    }
+#endif
+
+    void WritePadding(std::ostream &_file, uint64_t _offset)
+    {
+        const char padding[16] = {};
+        for (uint64_t at = (uint64_t)_file.tellp(); at < _offset && _file.good(); at += sizeof(padding))
+            _file.write(padding, std::min<uint64_t>(sizeof(padding), _offset - at));
+    }
+
+    bool WriteFileAtomically(const std::string &_path, const std::function<void(std::ostream &_file)> &_write)
+    {
+        // a name per thread, two workers may write the same file when it is requested twice in one batch
+        std::string temporaryPath = _path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return false;
+
+            _write(file);
+
+            if (!file.good())
+            {
+                file.close();
+                std::remove(temporaryPath.c_str());
+                return false;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporaryPath, _path, error);
+        if (error)
+        {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+} // end of Canis namespace
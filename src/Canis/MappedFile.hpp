@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace Canis
+{
+    // read only view of a whole file mapped into memory, unmapped when closed or destroyed
+    class MappedFile
+    {
+    public:
+        MappedFile() {}
+        ~MappedFile() { Close(); }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        // returns false when the file can not be opened, an empty file opens with GetData() == nullptr
+        bool Open(const std::string &_path);
+        void Close();
+
+        bool IsOpen() const { return m_open; }
+        const char *GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+
+    private:
+        const char *m_data = nullptr;
+        size_t m_size = 0;
+        bool m_open = false;
+#ifdef _WIN32
+        void *m_file = nullptr;
+        void *m_mapping = nullptr;
+#endif
+    };
+
+    // blobs in the binary formats start on 16 byte boundaries so the mapped floats and indices are aligned
+    inline uint64_t AlignBlob(uint64_t _offset)
+    {
+        return (_offset + 15) & ~(uint64_t)15;
+    }
+
+    // writes zeros until the stream is at _offset
+    void WritePadding(std::ostream &_file, uint64_t _offset);
+
+    // _write fills a temporary file next to _path that is then renamed over it, so a crash never leaves half a file behind
+    // returns false and removes the temporary file when it can not be opened, _write leaves the stream failed or the rename fails
+    bool WriteFileAtomically(const std::string &_path, const std::function<void(std::ostream &_file)> &_write);
+} // end of Canis namespace
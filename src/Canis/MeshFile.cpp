@@ -0,0 +1,155 @@
+#include "MeshFile.hpp"
+#include "IOManager.hpp"
+#include "MeshOptimizer.hpp"
+#include "AssetPack.hpp"
+#include "Debug.hpp"
+
+#include <cstring>
+
+namespace Canis
+{
+    namespace
+    {
+        const char MESH_MAGIC[4] = {'C', 'M', 'S', 'H'};
+
+        bool OpenMeshCache(const std::string &_objPath, MeshData &_mesh)
+        {
+            if (!_mesh.file.Open(GetMeshCachePath(_objPath)))
+                return false;
+
+            const MeshFileHeader *header = (const MeshFileHeader *)_mesh.file.GetData();
+            size_t size = _mesh.file.GetSize();
+
+            if (size < sizeof(MeshFileHeader) || memcmp(header->magic, MESH_MAGIC, 4) != 0 || header->version != MESH_FILE_VERSION)
+                return false;
+
+            uint64_t sourceSize = 0;
+            int64_t sourceTime = 0;
+            // a cache without its obj is still used
+            if (GetFileStamp(_objPath, sourceSize, sourceTime) && (sourceSize != header->sourceSize || sourceTime != header->sourceTime))
+                return false;
+
+            if (header->attributeCount > MAX_MESH_ATTRIBUTES ||
+                header->vertexOffset + (uint64_t)header->vertexCount * header->vertexStride > size ||
+                header->indexOffset + (uint64_t)header->indexCount * sizeof(uint32_t) > size)
+                return false;
+
+            _mesh.vertices = (const float *)(_mesh.file.GetData() + header->vertexOffset);
+            _mesh.indices = (const uint32_t *)(_mesh.file.GetData() + header->indexOffset);
+            _mesh.vertexCount = header->vertexCount;
+            _mesh.indexCount = header->indexCount;
+            _mesh.vertexStride = header->vertexStride;
+            _mesh.attributeCount = header->attributeCount;
+            memcpy(_mesh.attributes, header->attributes, sizeof(_mesh.attributes));
+            _mesh.boundsMin = glm::vec3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]);
+            _mesh.boundsMax = glm::vec3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]);
+            _mesh.fromCache = true;
+            return true;
+        }
+
+        bool ParseMesh(const std::string &_objPath, MeshData &_mesh)
+        {
+            std::vector<glm::vec3> positions;
+            std::vector<glm::vec2> uvs;
+            std::vector<glm::vec3> normals;
+
+            if (!LoadOBJ(_objPath, positions, uvs, normals))
+                return false;
+
+            std::vector<float> vertices = {};
+            vertices.reserve(positions.size() * 8);
+
+            for (size_t i = 0; i < positions.size(); i++)
+            {
+                vertices.push_back(positions[i].x);
+                vertices.push_back(positions[i].y);
+                vertices.push_back(positions[i].z);
+                vertices.push_back(normals[i].x);
+                vertices.push_back(normals[i].y);
+                vertices.push_back(normals[i].z);
+                vertices.push_back(uvs[i].x);
+                vertices.push_back(uvs[i].y);
+            }
+
+            BuildIndexedMesh(vertices, _mesh.parsedVertices, _mesh.parsedIndices);
+            OptimizeVertexCache(_mesh.parsedIndices, _mesh.parsedVertices.size() / 8);
+            OptimizeVertexFetch(_mesh.parsedVertices, _mesh.parsedIndices);
+
+            _mesh.vertices = _mesh.parsedVertices.data();
+            _mesh.indices = _mesh.parsedIndices.data();
+            _mesh.vertexCount = _mesh.parsedVertices.size() / 8;
+            _mesh.indexCount = _mesh.parsedIndices.size();
+            _mesh.fromCache = false;
+
+            if (_mesh.vertexCount > 0)
+            {
+                _mesh.boundsMin = glm::vec3(_mesh.vertices[0], _mesh.vertices[1], _mesh.vertices[2]);
+                _mesh.boundsMax = _mesh.boundsMin;
+            }
+
+            for (uint32_t i = 0; i < _mesh.vertexCount; i++)
+            {
+                glm::vec3 position = glm::vec3(_mesh.vertices[i * 8], _mesh.vertices[i * 8 + 1], _mesh.vertices[i * 8 + 2]);
+                _mesh.boundsMin = glm::min(_mesh.boundsMin, position);
+                _mesh.boundsMax = glm::max(_mesh.boundsMax, position);
+            }
+
+            return true;
+        }
+
+        void SaveMeshCache(const std::string &_objPath, const MeshData &_mesh)
+        {
+            MeshFileHeader header = {};
+            memcpy(header.magic, MESH_MAGIC, 4);
+            header.version = MESH_FILE_VERSION;
+            GetFileStamp(_objPath, header.sourceSize, header.sourceTime);
+            header.boundsMin[0] = _mesh.boundsMin.x;
+            header.boundsMin[1] = _mesh.boundsMin.y;
+            header.boundsMin[2] = _mesh.boundsMin.z;
+            header.boundsMax[0] = _mesh.boundsMax.x;
+            header.boundsMax[1] = _mesh.boundsMax.y;
+            header.boundsMax[2] = _mesh.boundsMax.z;
+            header.vertexCount = _mesh.vertexCount;
+            header.indexCount = _mesh.indexCount;
+            header.vertexStride = _mesh.vertexStride;
+            header.attributeCount = _mesh.attributeCount;
+            memcpy(header.attributes, _mesh.attributes, sizeof(header.attributes));
+            header.vertexOffset = AlignBlob(sizeof(MeshFileHeader));
+            header.indexOffset = AlignBlob(header.vertexOffset + (uint64_t)_mesh.vertexCount * _mesh.vertexStride);
+
+            auto write = [&](std::ostream &_file)
+            {
+                _file.write((const char *)&header, sizeof(header));
+                WritePadding(_file, header.vertexOffset);
+                _file.write((const char *)_mesh.vertices, (uint64_t)_mesh.vertexCount * _mesh.vertexStride);
+                WritePadding(_file, header.indexOffset);
+                _file.write((const char *)_mesh.indices, (uint64_t)_mesh.indexCount * sizeof(uint32_t));
+            };
+
+            std::string path = GetMeshCachePath(_objPath);
+            if (!WriteFileAtomically(path, write))
+                Warning("Can not write mesh cache " + path);
+        }
+    }
+
+    std::string GetMeshCachePath(const std::string &_objPath)
+    {
+        return _objPath + ".cmesh";
+    }
+
+    bool LoadMeshData(const std::string &_objPath, MeshData &_mesh, bool _useCache)
+    {
+        if (_useCache && OpenMeshCache(_objPath, _mesh))
+            return true;
+
+        _mesh.file.Close();
+
+        if (!ParseMesh(_objPath, _mesh))
+            return false;
+
+        if (_useCache)
+            SaveMeshCache(_objPath, _mesh);
+
+        return true;
+    }
+} // end of Canis namespace
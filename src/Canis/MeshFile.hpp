@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "AssetPack.hpp"
+
+namespace Canis
+{
+    // bump when the layout of the file or of the data LoadModel writes into it changes, older files are rebuilt
+    const uint32_t MESH_FILE_VERSION = 2;
+    const int MAX_MESH_ATTRIBUTES = 4;
+
+    // one float attribute of an interleaved vertex
+    struct MeshAttribute
+    {
+        uint32_t location = 0;
+        uint32_t components = 0;
+        uint32_t offset = 0; // bytes from the start of the vertex
+    };
+
+    // start of a .cmesh file, the vertex and index blobs follow at vertexOffset and indexOffset
+    struct MeshFileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceSize; // size and write time of the obj the file was built from
+        int64_t sourceTime;
+        float boundsMin[3];
+        float boundsMax[3];
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t vertexStride;
+        uint32_t attributeCount;
+        MeshAttribute attributes[MAX_MESH_ATTRIBUTES];
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+    };
+
+    // a mesh ready for glBufferData, the pointers point into the mapped .cmesh, the mounted pack or the parsed vectors
+    // the default layout is position, normal, uv like LoadModel and the chunk meshes use
+    struct MeshData
+    {
+        const float *vertices = nullptr;
+        const uint32_t *indices = nullptr;
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        uint32_t vertexStride = 8 * sizeof(float);
+        uint32_t attributeCount = 3;
+        MeshAttribute attributes[MAX_MESH_ATTRIBUTES] = {{0, 3, 0}, {1, 3, 3 * sizeof(float)}, {2, 2, 6 * sizeof(float)}};
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+        bool fromCache = false;
+
+        VirtualFile file;
+        std::vector<float> parsedVertices = {};
+        std::vector<unsigned int> parsedIndices = {};
+    };
+
+    // the binary copy of an obj is stored next to it
+    extern std::string GetMeshCachePath(const std::string &_objPath);
+
+    // maps the .cmesh when it was built from the obj as it is now, otherwise parses and indexes the obj and writes a new .cmesh
+    // with _useCache false the obj is always parsed and no file is written
+    extern bool LoadMeshData(const std::string &_objPath, MeshData &_mesh, bool _useCache = true);
+} // end of Canis namespace
@@ -0,0 +1,225 @@
+#include "MeshOptimizer.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace Canis
+{
+    namespace
+    {
+        const int VERTEX_FLOATS = 8;
+
+        // FNV-1a over the bytes of one vertex, identical bits mean an identical vertex
+        uint32_t HashVertex(const float *_vertex)
+        {
+            uint32_t words[VERTEX_FLOATS];
+            memcpy(words, _vertex, sizeof(words));
+
+            uint32_t hash = 2166136261u;
+            for (int i = 0; i < VERTEX_FLOATS; i++)
+            {
+                hash ^= words[i];
+                hash *= 16777619u;
+            }
+            return hash ^ (hash >> 15);
+        }
+
+        // triangles using each vertex, the triangles of vertex v are at offsets[v] to offsets[v + 1]
+        void BuildAdjacency(const std::vector<unsigned int> &_indices, unsigned int _vertexCount,
+                            std::vector<unsigned int> &_offsets, std::vector<unsigned int> &_triangles)
+        {
+            _offsets.assign(_vertexCount + 1, 0);
+
+            for (unsigned int index : _indices)
+                _offsets[index + 1]++;
+
+            for (unsigned int v = 0; v < _vertexCount; v++)
+                _offsets[v + 1] += _offsets[v];
+
+            std::vector<unsigned int> cursor(_offsets.begin(), _offsets.end() - 1);
+            _triangles.resize(_indices.size());
+
+            for (size_t i = 0; i < _indices.size(); i++)
+                _triangles[cursor[_indices[i]]++] = i / 3;
+        }
+    }
+
+    void BuildIndexedMesh(const std::vector<float> &_vertices, std::vector<float> &_uniqueVertices, std::vector<unsigned int> &_indices)
+    {
+        size_t vertexCount = _vertices.size() / VERTEX_FLOATS;
+
+        _uniqueVertices.clear();
+        _uniqueVertices.reserve(_vertices.size());
+        _indices.resize(vertexCount);
+
+        // open addressing table of unique vertex indices, at most half full
+        size_t tableSize = 16;
+        while (tableSize < vertexCount * 2)
+            tableSize *= 2;
+
+        std::vector<unsigned int> table(tableSize, ~0u);
+        unsigned int uniqueCount = 0;
+
+        for (size_t i = 0; i < vertexCount; i++)
+        {
+            const float *vertex = &_vertices[i * VERTEX_FLOATS];
+            size_t slot = HashVertex(vertex) & (tableSize - 1);
+
+            while (table[slot] != ~0u && memcmp(&_uniqueVertices[table[slot] * VERTEX_FLOATS], vertex, VERTEX_FLOATS * sizeof(float)) != 0)
+                slot = (slot + 1) & (tableSize - 1);
+
+            if (table[slot] == ~0u)
+            {
+                table[slot] = uniqueCount++;
+                _uniqueVertices.insert(_uniqueVertices.end(), vertex, vertex + VERTEX_FLOATS);
+            }
+
+            _indices[i] = table[slot];
+        }
+    }
+
+    void OptimizeVertexCache(std::vector<unsigned int> &_indices, unsigned int _vertexCount, unsigned int _cacheSize)
+    {
+        size_t triangleCount = _indices.size() / 3;
+
+        if (triangleCount == 0)
+            return;
+
+        std::vector<unsigned int> offsets;
+        std::vector<unsigned int> adjacency;
+        BuildAdjacency(_indices, _vertexCount, offsets, adjacency);
+
+        // triangles not emitted yet that use each vertex
+        std::vector<unsigned int> liveTriangles(_vertexCount);
+        for (unsigned int v = 0; v < _vertexCount; v++)
+            liveTriangles[v] = offsets[v + 1] - offsets[v];
+
+        // when each vertex last entered the cache, it is still cached while time - cacheTime < _cacheSize
+        std::vector<unsigned int> cacheTime(_vertexCount, 0);
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<unsigned int> deadEnds;
+        std::vector<unsigned int> candidates;
+        std::vector<unsigned int> result;
+        result.reserve(_indices.size());
+
+        unsigned int time = _cacheSize + 1;
+        unsigned int cursor = 1;
+        int fanning = 0;
+
+        while (fanning >= 0)
+        {
+            candidates.clear();
+
+            // emit every remaining triangle around the fanning vertex
+            for (unsigned int a = offsets[fanning]; a < offsets[fanning + 1]; a++)
+            {
+                unsigned int triangle = adjacency[a];
+
+                if (emitted[triangle])
+                    continue;
+
+                for (int corner = 0; corner < 3; corner++)
+                {
+                    unsigned int v = _indices[triangle * 3 + corner];
+
+                    result.push_back(v);
+                    deadEnds.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+
+                    if (time - cacheTime[v] > _cacheSize)
+                        cacheTime[v] = time++;
+                }
+
+                emitted[triangle] = 1;
+            }
+
+            // next fan around the vertex that stays cached for all of its remaining triangles and entered the cache earliest
+            int next = -1;
+            int bestPriority = -1;
+
+            for (unsigned int v : candidates)
+            {
+                if (liveTriangles[v] == 0)
+                    continue;
+
+                int priority = 0;
+                if (time - cacheTime[v] + 2 * liveTriangles[v] <= _cacheSize)
+                    priority = time - cacheTime[v];
+
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    next = v;
+                }
+            }
+
+            // otherwise go back to a recently used vertex, then to the first vertex with triangles left
+            while (next < 0 && !deadEnds.empty())
+            {
+                unsigned int v = deadEnds.back();
+                deadEnds.pop_back();
+
+                if (liveTriangles[v] > 0)
+                    next = v;
+            }
+
+            while (next < 0 && cursor < _vertexCount)
+            {
+                if (liveTriangles[cursor] > 0)
+                    next = cursor;
+                cursor++;
+            }
+
+            fanning = next;
+        }
+
+        _indices.swap(result);
+    }
+
+    void OptimizeVertexFetch(std::vector<float> &_vertices, std::vector<unsigned int> &_indices)
+    {
+        size_t vertexCount = _vertices.size() / VERTEX_FLOATS;
+
+        std::vector<unsigned int> remap(vertexCount, ~0u);
+        std::vector<float> reordered(_vertices.size());
+        unsigned int nextVertex = 0;
+
+        for (unsigned int &index : _indices)
+        {
+            if (remap[index] == ~0u)
+            {
+                remap[index] = nextVertex;
+                memcpy(&reordered[nextVertex * VERTEX_FLOATS], &_vertices[index * VERTEX_FLOATS], VERTEX_FLOATS * sizeof(float));
+                nextVertex++;
+            }
+
+            index = remap[index];
+        }
+
+        // vertices no triangle uses are dropped
+        reordered.resize(nextVertex * VERTEX_FLOATS);
+        _vertices.swap(reordered);
+    }
+
+    float ComputeACMR(const std::vector<unsigned int> &_indices, unsigned int _vertexCount, unsigned int _cacheSize)
+    {
+        if (_indices.size() < 3)
+            return 0.0f;
+
+        // a vertex is cached while fewer than _cacheSize misses happened since it was loaded
+        std::vector<unsigned int> loadedAt(_vertexCount, 0);
+        unsigned int misses = 0;
+
+        for (unsigned int index : _indices)
+        {
+            if (loadedAt[index] == 0 || misses - loadedAt[index] >= _cacheSize)
+            {
+                misses++;
+                loadedAt[index] = misses;
+            }
+        }
+
+        return (float)misses / (_indices.size() / 3);
+    }
+} // end of Canis namespace
@@ -0,0 +1,21 @@
+#pragma once
+#include <vector>
+
+namespace Canis
+{
+    // post transform cache size the optimizer and ACMR assume, small enough for older gpus
+    const unsigned int VERTEX_CACHE_SIZE = 16;
+
+    // merges vertices with identical position, normal and uv
+    // _vertices is a triangle list of interleaved position, normal, uv (8 floats) like LoadModel builds
+    extern void BuildIndexedMesh(const std::vector<float> &_vertices, std::vector<float> &_uniqueVertices, std::vector<unsigned int> &_indices);
+
+    // reorders triangles so vertices are reused while still in the post transform cache (Tipsify, Sander et al. 2007)
+    extern void OptimizeVertexCache(std::vector<unsigned int> &_indices, unsigned int _vertexCount, unsigned int _cacheSize = VERTEX_CACHE_SIZE);
+
+    // reorders vertices into the order the index buffer first uses them so fetches walk memory forward
+    extern void OptimizeVertexFetch(std::vector<float> &_vertices, std::vector<unsigned int> &_indices);
+
+    // average cache miss ratio, vertex shader runs per triangle with a FIFO cache, 3.0 means no reuse
+    extern float ComputeACMR(const std::vector<unsigned int> &_indices, unsigned int _vertexCount, unsigned int _cacheSize = VERTEX_CACHE_SIZE);
+} // end of Canis namespace
@@ -1,63 +1,177 @@
 #include "Model.hpp"
 #include "IOManager.hpp"
 #include "Debug.hpp"
+#include "MeshFile.hpp"
+#include "Canis.hpp"
 
 #include <GL/glew.h>
+#include <algorithm>
 
 namespace Canis
 {
+    namespace
+    {
+        void ComputeBounds(Model &_model)
+        {
+            unsigned int floats = _model.vertexStride / sizeof(float);
+
+            if (_model.vertices.size() >= floats)
+            {
+                _model.boundsMin = glm::vec3(_model.vertices[0], _model.vertices[1], _model.vertices[2]);
+                _model.boundsMax = _model.boundsMin;
+            }
+
+            for (int i = 0; i + floats <= _model.vertices.size(); i += floats)
+            {
+                glm::vec3 position = glm::vec3(_model.vertices[i], _model.vertices[i + 1], _model.vertices[i + 2]);
+                _model.boundsMin = glm::min(_model.boundsMin, position);
+                _model.boundsMax = glm::max(_model.boundsMax, position);
+            }
+
+            _model.boundsCenter = (_model.boundsMin + _model.boundsMax) * 0.5f;
+            _model.boundsRadius = glm::length(_model.boundsMax - _model.boundsCenter);
+        }
+
+        void SetBounds(Model &_model, glm::vec3 _boundsMin, glm::vec3 _boundsMax)
+        {
+            _model.boundsMin = _boundsMin;
+            _model.boundsMax = _boundsMax;
+            _model.boundsCenter = (_model.boundsMin + _model.boundsMax) * 0.5f;
+            _model.boundsRadius = glm::length(_model.boundsMax - _model.boundsCenter);
+        }
+
+        // uploads the mesh into a new VAO, the bounds are set by the caller
+        void UploadModel(Model &_model, const MeshData &_mesh)
+        {
+            _model.vertexCount = _mesh.vertexCount;
+            _model.indexCount = _mesh.indexCount;
+            _model.vertexStride = _mesh.vertexStride;
+
+            glGenVertexArrays(1, &_model.VAO);
+            glGenBuffers(1, &_model.VBO);
+
+            glBindVertexArray(_model.VAO);
+
+            glBindBuffer(GL_ARRAY_BUFFER, _model.VBO);
+            glBufferData(GL_ARRAY_BUFFER, (size_t)_mesh.vertexStride * _mesh.vertexCount, _mesh.vertices, GL_STATIC_DRAW);
+
+            // pos, normal and uv for everything LoadModel and CreateModel build
+            for (uint32_t i = 0; i < _mesh.attributeCount; i++)
+            {
+                const MeshAttribute &attribute = _mesh.attributes[i];
+                glVertexAttribPointer(attribute.location, attribute.components, GL_FLOAT, GL_FALSE, _mesh.vertexStride, (void *)(size_t)attribute.offset);
+                glEnableVertexAttribArray(attribute.location);
+            }
+
+            // the element buffer binding is stored in the VAO
+            if (_mesh.indexCount > 0)
+            {
+                glGenBuffers(1, &_model.EBO);
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _model.EBO);
+                glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * _mesh.indexCount, _mesh.indices, GL_STATIC_DRAW);
+            }
+
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glBindVertexArray(0);
+        }
+    }
+
     Model LoadModel(std::string _path)
     {
         Model model;
         model.path = _path;
 
-        if (LoadOBJ(model.path, model.positions, model.uvs, model.normals) == false)
+        MeshData mesh;
+        if (LoadMeshData(model.path, mesh, GetConfig().meshCache) == false)
         {
             Canis::FatalError("Failed to load model at path " + model.path);
         }
 
-        for (int i = 0; i < model.positions.size(); i++)
+        SetBounds(model, mesh.boundsMin, mesh.boundsMax);
+        UploadModel(model, mesh);
+
+        return model;
+    }
+
+    Model CreateModel(const std::vector<float> &_vertices, std::string _name, const MeshAttribute *_attributes, unsigned int _attributeCount)
+    {
+        Model model;
+        model.path = _name;
+        model.vertices = _vertices;
+
+        MeshData mesh;
+
+        if (_attributeCount > 0)
         {
-            model.vertices.push_back(model.positions[i].x);
-            model.vertices.push_back(model.positions[i].y);
-            model.vertices.push_back(model.positions[i].z);
-            model.vertices.push_back(model.normals[i].x);
-            model.vertices.push_back(model.normals[i].y);
-            model.vertices.push_back(model.normals[i].z);
-            model.vertices.push_back(model.uvs[i].x);
-            model.vertices.push_back(model.uvs[i].y);
-        }
+            mesh.attributeCount = _attributeCount;
+            mesh.vertexStride = 0;
 
-        glGenVertexArrays(1, &model.VAO);
-        glGenBuffers(1, &model.VBO);
+            for (unsigned int i = 0; i < _attributeCount; i++)
+            {
+                mesh.attributes[i] = _attributes[i];
+                mesh.vertexStride = std::max(mesh.vertexStride, _attributes[i].offset + _attributes[i].components * (uint32_t)sizeof(float));
+            }
+        }
 
-        glBindVertexArray(model.VAO);
+        model.vertexStride = mesh.vertexStride;
+        mesh.vertices = model.vertices.data();
+        mesh.vertexCount = model.vertices.size() * sizeof(float) / model.vertexStride;
 
-        glBindBuffer(GL_ARRAY_BUFFER, model.VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * model.vertices.size(), &model.vertices[0], GL_STATIC_DRAW);
+        ComputeBounds(model);
+        UploadModel(model, mesh);
 
-        // pos
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)0);
-        glEnableVertexAttribArray(0);
+        return model;
+    }
 
-        // normal
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(3 * sizeof(float)));
-        glEnableVertexAttribArray(1);
+    void UpdateModel(Model &_model, const std::vector<float> &_vertices)
+    {
+        _model.vertices = _vertices;
+        _model.vertexCount = _model.vertices.size() * sizeof(float) / _model.vertexStride;
 
-        // uv
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(6 * sizeof(float)));
-        glEnableVertexAttribArray(2);
+        ComputeBounds(_model);
 
+        glBindBuffer(GL_ARRAY_BUFFER, _model.VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(float) * _model.vertices.size(), _model.vertices.data(), GL_STATIC_DRAW);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+    }
 
-        return model;
+    void UnloadModel(Model &_model)
+    {
+        glDeleteBuffers(1, &_model.VBO);
+        if (_model.EBO != 0)
+            glDeleteBuffers(1, &_model.EBO);
+        glDeleteVertexArrays(1, &_model.VAO);
+
+        _model.VAO = 0;
+        _model.VBO = 0;
+        _model.EBO = 0;
+        _model.vertexCount = 0;
+        _model.indexCount = 0;
+        _model.vertices.clear();
     }
 
     void Draw(Model &_model)
     {
         glBindVertexArray(_model.VAO);
-        glDrawArrays(GL_TRIANGLES, 0, _model.vertices.size()/8);
+        DrawBound(_model);
         glBindVertexArray(0);
     }
+
+    void DrawBound(const Model &_model, int _instanceCount)
+    {
+        if (_model.indexCount == 0)
+        {
+            if (_instanceCount > 0)
+                glDrawArraysInstanced(GL_TRIANGLES, 0, _model.vertexCount, _instanceCount);
+            else
+                glDrawArrays(GL_TRIANGLES, 0, _model.vertexCount);
+        }
+        else
+        {
+            if (_instanceCount > 0)
+                glDrawElementsInstanced(GL_TRIANGLES, _model.indexCount, GL_UNSIGNED_INT, (void *)0, _instanceCount);
+            else
+                glDrawElements(GL_TRIANGLES, _model.indexCount, GL_UNSIGNED_INT, (void *)0);
+        }
+    }
 }
\ No newline at end of file
@@ -2,21 +2,46 @@
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
+#include "MeshFile.hpp"
 
 namespace Canis
 {
     struct Model
     {
         std::string path;
-        unsigned int VAO;
-        unsigned int VBO;
+        unsigned int VAO = 0;
+        unsigned int VBO = 0;
+        unsigned int EBO = 0;
+        unsigned int vertexCount = 0;
+        unsigned int indexCount = 0; // 0 for models drawn with glDrawArrays e.g. chunk meshes
+        unsigned int vertexStride = 8 * sizeof(float); // bytes per vertex of models from CreateModel
+
+        // cpu copy of the vertices, only kept for models from CreateModel, loaded models only live on the gpu
         std::vector<float> vertices = {};
-        std::vector<glm::vec3> positions = {};
-        std::vector<glm::vec2> uvs = {};
-        std::vector<glm::vec3> normals = {};
+
+        // local space bounds, filled by LoadModel
+        glm::vec3 boundsMin = glm::vec3(0.0f);
+        glm::vec3 boundsMax = glm::vec3(0.0f);
+        glm::vec3 boundsCenter = glm::vec3(0.0f);
+        float boundsRadius = 0.0f;
     };
 
+    // vertices are deduplicated into an index buffer that is ordered for the vertex cache
+    // the result is cached in a binary .cmesh next to the obj, see MeshFile.hpp
     extern Model LoadModel(std::string _path);
 
+    // builds a model from interleaved position, normal, uv vertices e.g. generated chunk meshes
+    // _attributes replaces that layout for vertices with other attributes
+    extern Model CreateModel(const std::vector<float> &_vertices, std::string _name, const MeshAttribute *_attributes = nullptr, unsigned int _attributeCount = 0);
+
+    // replaces the vertices of a model from CreateModel, the VAO stays the same
+    extern void UpdateModel(Model &_model, const std::vector<float> &_vertices);
+
+    // frees the VAO and buffers, the model can not be drawn afterwards
+    extern void UnloadModel(Model &_model);
+
     extern void Draw(Model &_model);
+
+    // draws the model with its VAO already bound, one instance unless _instanceCount is given
+    extern void DrawBound(const Model &_model, int _instanceCount = 0);
 } // end of Canis namespace
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "PaletteChunk.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Canis
+{
+    namespace
+    {
+        // widths that divide 64 so an index never crosses a word
+        int BitsFor(size_t _paletteSize)
+        {
+            if (_paletteSize <= 1)
+                return 0;
+            if (_paletteSize <= 2)
+                return 1;
+            if (_paletteSize <= 4)
+                return 2;
+            if (_paletteSize <= 16)
+                return 4;
+            return 8;
+        }
+
+        int ShiftFor(int _bits)
+        {
+            return (_bits == 8) ? 3 : _bits >> 1;
+        }
+    }
+
+    void PaletteChunk::Fill(uint8_t _block)
+    {
+        m_palette = std::vector<uint8_t>(1, _block);
+        m_words = std::vector<uint64_t>();
+        m_runs = std::vector<Run>();
+        m_bits = 0;
+        m_shift = 0;
+    }
+
+    void PaletteChunk::Encode(const uint8_t *_blocks)
+    {
+        int16_t slots[256];
+        std::fill(slots, slots + 256, (int16_t)-1);
+        uint8_t palette[256];
+        int paletteSize = 0;
+        uint8_t indices[VOLUME];
+        size_t runCount = 1;
+
+        for (int i = 0; i < VOLUME; i++)
+        {
+            uint8_t block = _blocks[i];
+            if (slots[block] < 0)
+            {
+                slots[block] = (int16_t)paletteSize;
+                palette[paletteSize++] = block;
+            }
+
+            indices[i] = (uint8_t)slots[block];
+            runCount += (i > 0 && block != _blocks[i - 1]);
+        }
+
+        m_palette = std::vector<uint8_t>(palette, palette + paletteSize);
+        m_runs = std::vector<Run>();
+
+        int bits = BitsFor(paletteSize);
+        size_t packedBytes = (size_t)VOLUME * bits / 8;
+
+        if (bits == 0 || runCount * sizeof(Run) >= packedBytes)
+        {
+            WriteIndices(indices, bits);
+            return;
+        }
+
+        m_words = std::vector<uint64_t>();
+        m_bits = (uint8_t)bits;
+        m_shift = (uint8_t)ShiftFor(bits);
+        m_runs.reserve(runCount);
+
+        for (int i = 1; i <= VOLUME; i++)
+        {
+            if (i == VOLUME || _blocks[i] != _blocks[i - 1])
+            {
+                Run run;
+                run.end = (uint16_t)i;
+                run.block = _blocks[i - 1];
+                m_runs.push_back(run);
+            }
+        }
+    }
+
+    void PaletteChunk::Decode(uint8_t *_blocks) const
+    {
+        if (!m_runs.empty())
+        {
+            int start = 0;
+            for (const Run &run : m_runs)
+            {
+                memset(_blocks + start, run.block, run.end - start);
+                start = run.end;
+            }
+            return;
+        }
+
+        if (m_bits == 0)
+        {
+            memset(_blocks, m_palette[0], VOLUME);
+            return;
+        }
+
+        const int PER_WORD = 64 >> m_shift;
+        const uint64_t MASK = (1u << m_bits) - 1;
+        const uint8_t *palette = m_palette.data();
+
+        for (size_t w = 0; w < m_words.size(); w++)
+        {
+            uint64_t word = m_words[w];
+            uint8_t *blocks = _blocks + w * PER_WORD;
+
+            for (int i = 0; i < PER_WORD; i++)
+                blocks[i] = palette[(word >> (i << m_shift)) & MASK];
+        }
+    }
+
+    void PaletteChunk::Set(int _index, uint8_t _block)
+    {
+        if (!m_runs.empty())
+            Pack(BitsFor(m_palette.size()));
+
+        int paletteIndex = FindPalette(_block);
+        if (paletteIndex < 0)
+        {
+            paletteIndex = (int)m_palette.size();
+            m_palette.push_back(_block);
+
+            if (m_palette.size() > (1u << m_bits))
+                Pack(BitsFor(m_palette.size()));
+        }
+
+        // the only id of the chunk
+        if (m_bits == 0)
+            return;
+
+        uint64_t &word = m_words[_index >> (6 - m_shift)];
+        int offset = (_index & ((64 >> m_shift) - 1)) << m_shift;
+        uint64_t mask = (uint64_t)((1u << m_bits) - 1) << offset;
+        word = (word & ~mask) | ((uint64_t)paletteIndex << offset);
+    }
+
+    void PaletteChunk::Compact()
+    {
+        uint8_t blocks[VOLUME];
+        Decode(blocks);
+        Encode(blocks);
+    }
+
+    uint8_t PaletteChunk::GetRun(int _index) const
+    {
+        auto run = std::upper_bound(m_runs.begin(), m_runs.end(), _index, [](int _i, const Run &_run) { return _i < _run.end; });
+        return run->block;
+    }
+
+    int PaletteChunk::FindPalette(uint8_t _block) const
+    {
+        for (size_t i = 0; i < m_palette.size(); i++)
+            if (m_palette[i] == _block)
+                return (int)i;
+
+        return -1;
+    }
+
+    void PaletteChunk::Pack(int _bits)
+    {
+        uint8_t indices[VOLUME];
+        ReadIndices(indices);
+        m_runs = std::vector<Run>();
+        WriteIndices(indices, _bits);
+    }
+
+    void PaletteChunk::ReadIndices(uint8_t *_indices) const
+    {
+        if (!m_runs.empty())
+        {
+            int start = 0;
+            for (const Run &run : m_runs)
+            {
+                memset(_indices + start, FindPalette(run.block), run.end - start);
+                start = run.end;
+            }
+            return;
+        }
+
+        if (m_bits == 0)
+        {
+            memset(_indices, 0, VOLUME);
+            return;
+        }
+
+        const int PER_WORD = 64 >> m_shift;
+        const uint64_t MASK = (1u << m_bits) - 1;
+
+        for (size_t w = 0; w < m_words.size(); w++)
+        {
+            uint64_t word = m_words[w];
+            uint8_t *indices = _indices + w * PER_WORD;
+
+            for (int i = 0; i < PER_WORD; i++)
+                indices[i] = (uint8_t)((word >> (i << m_shift)) & MASK);
+        }
+    }
+
+    void PaletteChunk::WriteIndices(const uint8_t *_indices, int _bits)
+    {
+        m_bits = (uint8_t)_bits;
+        m_shift = (uint8_t)ShiftFor(_bits);
+
+        if (_bits == 0)
+        {
+            m_words = std::vector<uint64_t>();
+            return;
+        }
+
+        const int PER_WORD = 64 >> m_shift;
+        m_words = std::vector<uint64_t>(VOLUME / PER_WORD, 0);
+
+        for (size_t w = 0; w < m_words.size(); w++)
+        {
+            uint64_t word = 0;
+            const uint8_t *indices = _indices + w * PER_WORD;
+
+            for (int i = 0; i < PER_WORD; i++)
+                word |= (uint64_t)indices[i] << (i << m_shift);
+            m_words[w] = word;
+        }
+    }
+} // end of Canis namespace
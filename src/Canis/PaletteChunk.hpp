@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "VoxelGrid.hpp"
+
+namespace Canis
+{
+    // one chunk of blocks in VoxelGrid's CHUNK_VOLUME layout as indices into a palette of the block ids it holds
+    // the indices are packed at 0, 1, 2, 4 or 8 bits so they never cross a word, 0 bits is a chunk of one block id
+    // Encode and Compact keep runs of the same block instead when those are smaller, solid ground and sky are a few runs
+    class PaletteChunk
+    {
+    public:
+        static const int VOLUME = VoxelGrid::CHUNK_VOLUME;
+
+        // every block of the chunk is _block
+        void Fill(uint8_t _block);
+
+        // from CHUNK_VOLUME raw blocks, with the smallest palette and the runs when they are smaller
+        void Encode(const uint8_t *_blocks);
+        // back to CHUNK_VOLUME raw blocks, the fast way to walk every block
+        void Decode(uint8_t *_blocks) const;
+
+        uint8_t Get(int _index) const
+        {
+            if (!m_runs.empty())
+                return GetRun(_index);
+            if (m_bits == 0)
+                return m_palette[0];
+
+            int shift = m_shift;
+            uint64_t word = m_words[_index >> (6 - shift)];
+            int offset = (_index & ((64 >> shift) - 1)) << shift;
+            return m_palette[(word >> offset) & ((1u << m_bits) - 1)];
+        }
+
+        uint8_t Get(int _x, int _y, int _z) const { return Get(Index(_x, _y, _z)); }
+
+        // a new block id grows the palette and repacks the indices when they run out of bits, runs are unpacked first
+        // ids that are no longer used stay in the palette until Compact
+        void Set(int _index, uint8_t _block);
+        void Set(int _x, int _y, int _z, uint8_t _block) { Set(Index(_x, _y, _z), _block); }
+
+        // drops unused ids and picks the smaller of packed indices and runs again
+        void Compact();
+
+        int GetBitsPerBlock() const { return m_bits; }
+        int GetPaletteSize() const { return (int)m_palette.size(); }
+        bool IsRunLength() const { return !m_runs.empty(); }
+        size_t GetRunCount() const { return m_runs.size(); }
+        // the object and everything it allocated
+        size_t GetMemoryUsage() const
+        {
+            return sizeof(PaletteChunk) + m_palette.capacity() + m_words.capacity() * sizeof(uint64_t) + m_runs.capacity() * sizeof(Run);
+        }
+
+        static int Index(int _x, int _y, int _z) { return (_y * CHUNK_SIZE + _x) * CHUNK_SIZE + _z; }
+
+    private:
+        struct Run
+        {
+            uint16_t end = 0; // one past the last block of the run
+            uint8_t block = 0;
+        };
+
+        uint8_t GetRun(int _index) const;
+        int FindPalette(uint8_t _block) const;
+        // repacks the palette indices at _bits
+        void Pack(int _bits);
+        void ReadIndices(uint8_t *_indices) const;
+        void WriteIndices(const uint8_t *_indices, int _bits);
+
+        std::vector<uint8_t> m_palette = {0};
+        std::vector<uint64_t> m_words = {};
+        std::vector<Run> m_runs = {};
+        uint8_t m_bits = 0;
+        uint8_t m_shift = 0; // log2 of m_bits
+    };
+} // end of Canis namespace
@@ -0,0 +1,112 @@
+#include "RenderQueue.hpp"
+#include "Debug.hpp"
+
+#include <algorithm>
+
+namespace Canis
+{
+    void RenderQueue::Clear()
+    {
+        m_commands.clear();
+
+        // the queue is empty so no key made with the old slots is left to collide with the new ones
+        if (m_slotsFull)
+        {
+            m_shaderSlots.clear();
+            m_textureSlots.clear();
+            m_vaoSlots.clear();
+            m_slotsFull = false;
+        }
+    }
+
+    void RenderQueue::Push(uint64_t _key, unsigned int _entity)
+    {
+        m_commands.push_back({_key, _entity});
+    }
+
+    // LSD radix sort on 8 bit digits, digits that are the same for every key are skipped
+    void RenderQueue::Sort()
+    {
+        size_t count = m_commands.size();
+
+        if (count < 2)
+            return;
+
+        m_scratch.resize(count);
+
+        RenderCommand *source = m_commands.data();
+        RenderCommand *destination = m_scratch.data();
+
+        for (int shift = 0; shift < 64; shift += 8)
+        {
+            size_t histogram[256] = {};
+
+            for (size_t i = 0; i < count; i++)
+                histogram[(source[i].key >> shift) & 0xFF]++;
+
+            if (histogram[(source[0].key >> shift) & 0xFF] == count)
+                continue;
+
+            size_t offset = 0;
+            for (int digit = 0; digit < 256; digit++)
+            {
+                size_t digitCount = histogram[digit];
+                histogram[digit] = offset;
+                offset += digitCount;
+            }
+
+            for (size_t i = 0; i < count; i++)
+                destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+
+            std::swap(source, destination);
+        }
+
+        if (source != m_commands.data())
+            m_commands.swap(m_scratch);
+    }
+
+    uint64_t RenderQueue::MakeKey(RenderPass _pass, unsigned int _programId, unsigned int _albedoId, unsigned int _specularId, unsigned int _emissionId, unsigned int _vao, float _depth)
+    {
+        // texture names are small so 21 bits each is plenty
+        uint64_t textureSet = ((uint64_t)_albedoId << 42) | ((uint64_t)_specularId << 21) | _emissionId;
+
+        // depth is expected in 0.0 - 1.0, closer objects sort first
+        uint64_t maxDepth = (1ull << DEPTH_BITS) - 1;
+        uint64_t depth = (uint64_t)(std::clamp(_depth, 0.0f, 1.0f) * maxDepth);
+
+        uint64_t state = GetSlot(m_shaderSlots, _programId, SHADER_BITS);
+        state = (state << TEXTURE_BITS) | GetSlot(m_textureSlots, textureSet, TEXTURE_BITS);
+        state = (state << VAO_BITS) | GetSlot(m_vaoSlots, _vao, VAO_BITS);
+
+        const int STATE_BITS = SHADER_BITS + TEXTURE_BITS + VAO_BITS;
+        uint64_t key = (uint64_t)_pass;
+
+        // blending needs the farthest first, state changes come second
+        if (_pass == TRANSPARENT_PASS)
+            return (((key << DEPTH_BITS) | (maxDepth - depth)) << STATE_BITS) | state;
+
+        return (((key << STATE_BITS) | state) << DEPTH_BITS) | depth;
+    }
+
+    unsigned int RenderQueue::GetSlot(std::unordered_map<uint64_t, unsigned int> &_slots, uint64_t _id, int _bits)
+    {
+        auto it = _slots.find(_id);
+
+        if (it != _slots.end())
+            return it->second;
+
+        // slots wrap until the next Clear rebuilds the maps, the key still sorts but runs may be split
+        if (_slots.size() >= (1u << _bits))
+        {
+            if (!m_warnedSlots)
+                Warning("RenderQueue ran out of sort key slots, they are rebuilt next frame");
+
+            m_warnedSlots = true;
+            m_slotsFull = true;
+        }
+
+        unsigned int slot = _slots.size() & ((1u << _bits) - 1);
+        _slots[_id] = slot;
+        return slot;
+    }
+} // end of Canis namespace
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+namespace Canis
+{
+    enum RenderPass
+    {
+        OPAQUE_PASS = 0,
+        TRANSPARENT_PASS = 1
+    };
+
+    struct RenderCommand
+    {
+        uint64_t key;
+        unsigned int entity;
+    };
+
+    // key layout from most to least significant bits
+    // opaque      | pass 2 | shader 10 | texture set 14 | vao 14 | depth 24 |
+    // transparent | pass 2 | inverted depth 24 | shader 10 | texture set 14 | vao 14 |
+    // opaque draws are grouped by state and go front to back inside a group, transparent ones go back to front
+    class RenderQueue
+    {
+    public:
+        static const int PASS_BITS = 2;
+        static const int SHADER_BITS = 10;
+        static const int TEXTURE_BITS = 14;
+        static const int VAO_BITS = 14;
+        static const int DEPTH_BITS = 24;
+
+        void Clear();
+        void Push(uint64_t _key, unsigned int _entity);
+        void Sort();
+        const std::vector<RenderCommand>& GetCommands() const { return m_commands; }
+
+        uint64_t MakeKey(RenderPass _pass, unsigned int _programId, unsigned int _albedoId, unsigned int _specularId, unsigned int _emissionId, unsigned int _vao, float _depth);
+
+    private:
+        std::vector<RenderCommand> m_commands = {};
+        std::vector<RenderCommand> m_scratch = {};
+
+        // gl names are remapped to small slots so they fit in the key
+        // the maps only grow, once one fills they are all cleared by the next Clear so freed names stop holding slots
+        std::unordered_map<uint64_t, unsigned int> m_shaderSlots = {};
+        std::unordered_map<uint64_t, unsigned int> m_textureSlots = {};
+        std::unordered_map<uint64_t, unsigned int> m_vaoSlots = {};
+        bool m_slotsFull = false;
+        bool m_warnedSlots = false;
+
+        unsigned int GetSlot(std::unordered_map<uint64_t, unsigned int> &_slots, uint64_t _id, int _bits);
+    };
+} // end of Canis namespace
@@ -1,11 +1,14 @@
 #include "Shader.hpp"
+#include "AssetPack.hpp"
 #include "Debug.hpp"
+#include "Data/UniformBlocks.hpp"
 
 #include <GL/glew.h>
 #include <SDL.h>
 
 #include <vector>
 #include <fstream>
+#include <algorithm>
 
 namespace Canis
 {
@@ -64,12 +67,16 @@ namespace Canis
             FatalError("Shader failed to link!\nOpengl Error: " + std::string(infoLog.begin(), infoLog.end()));
         } else {
             m_isLinked = true;
+            ReflectUniforms();
+            BindUniformBlocks();
         }
 
         glDetachShader(m_programId, m_vertexShaderId);
         glDetachShader(m_programId, m_fragmentShaderId);
         glDeleteShader(m_vertexShaderId);
         glDeleteShader(m_fragmentShaderId);
+        m_vertexShaderId = 0;
+        m_fragmentShaderId = 0;
     }
 
     void Shader::AddAttribute(const std::string &_attributeName)
@@ -77,10 +84,94 @@ namespace Canis
         glBindAttribLocation(m_programId, m_numberOfAttributes++, _attributeName.c_str());
     }
 
+    void Shader::AddDefine(const std::string &_define)
+    {
+        m_defines += "#define " + _define + "\n";
+    }
+
+    void Shader::ReflectUniforms()
+    {
+        m_uniforms.clear();
+
+        GLint count = 0;
+        GLint maxLength = 0;
+        glGetProgramiv(m_programId, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(m_programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+        std::vector<GLchar> name(maxLength + 1);
+
+        for (GLint i = 0; i < count; i++)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(m_programId, i, maxLength + 1, &length, &size, &type, name.data());
+
+            GLint location = glGetUniformLocation(m_programId, name.data());
+
+            // members of uniform blocks do not have a location
+            if (location < 0)
+                continue;
+
+            std::string uniformName(name.data(), length);
+            m_uniforms.push_back({HashUniformName(uniformName.c_str()), location});
+
+            // arrays report "NAME[0]", also register "NAME" and the other elements
+            if (uniformName.size() > 3 && uniformName.compare(uniformName.size() - 3, 3, "[0]") == 0)
+            {
+                std::string baseName = uniformName.substr(0, uniformName.size() - 3);
+                m_uniforms.push_back({HashUniformName(baseName.c_str()), location});
+
+                for (GLint element = 1; element < size; element++)
+                {
+                    std::string elementName = baseName + "[" + std::to_string(element) + "]";
+                    m_uniforms.push_back({HashUniformName(elementName.c_str()), glGetUniformLocation(m_programId, elementName.c_str())});
+                }
+            }
+        }
+
+        std::sort(m_uniforms.begin(), m_uniforms.end(), [](const UniformEntry &_a, const UniformEntry &_b) {
+            return _a.hash < _b.hash;
+        });
+
+        for (size_t i = 1; i < m_uniforms.size(); i++)
+            if (m_uniforms[i].hash == m_uniforms[i - 1].hash && m_uniforms[i].location != m_uniforms[i - 1].location)
+                Warning("Uniform name hash collision in shader program " + std::to_string(m_programId));
+    }
+
+    void Shader::BindUniformBlocks()
+    {
+        // shaders only declare the blocks they use so a missing block is not an error
+        GLuint frameIndex = glGetUniformBlockIndex(m_programId, FRAME_BLOCK_NAME);
+        if (frameIndex != GL_INVALID_INDEX)
+            glUniformBlockBinding(m_programId, frameIndex, FRAME_BLOCK_BINDING);
+
+        GLuint lightIndex = glGetUniformBlockIndex(m_programId, LIGHT_BLOCK_NAME);
+        if (lightIndex != GL_INVALID_INDEX)
+            glUniformBlockBinding(m_programId, lightIndex, LIGHT_BLOCK_BINDING);
+    }
+
+    UniformHandle Shader::GetUniformHandle(UniformId _id) const
+    {
+        auto it = std::lower_bound(m_uniforms.begin(), m_uniforms.end(), _id.hash, [](const UniformEntry &_entry, uint32_t _hash) {
+            return _entry.hash < _hash;
+        });
+
+        if (it == m_uniforms.end() || it->hash != _id.hash)
+            return UniformHandle{};
+
+        return UniformHandle{it->location};
+    }
+
+    UniformHandle Shader::GetUniformHandle(const std::string &_name) const
+    {
+        return GetUniformHandle(UniformId(HashUniformName(_name.c_str())));
+    }
+
     GLint Shader::GetUniformLocation(const std::string &_uniformName)
     {
-        GLint location = glGetUniformLocation(m_programId, _uniformName.c_str());
-        if (location == GL_INVALID_INDEX)
+        GLint location = GetUniformHandle(_uniformName).location;
+        if (location < 0)
             FatalError("Uniform " + _uniformName + " not found in shader!");
 
         return location;
@@ -102,74 +193,130 @@ namespace Canis
 
     void Shader::SetBool(const std::string &_name, bool _value) const
     {         
-        glUniform1i(glGetUniformLocation(m_programId, _name.c_str()), (int)_value); 
+        glUniform1i(GetUniformHandle(_name).location, (int)_value); 
     }
     
     void Shader::SetInt(const std::string &_name, int _value) const
     { 
-        glUniform1i(glGetUniformLocation(m_programId, _name.c_str()), _value); 
+        glUniform1i(GetUniformHandle(_name).location, _value); 
     }
     
     void Shader::SetFloat(const std::string &_name, float _value) const
     { 
-        glUniform1f(glGetUniformLocation(m_programId, _name.c_str()), _value); 
+        glUniform1f(GetUniformHandle(_name).location, _value); 
     }
     
     void Shader::SetVec2(const std::string &_name, const glm::vec2 &_value) const
     { 
-        glUniform2fv(glGetUniformLocation(m_programId, _name.c_str()), 1, &_value[0]); 
+        glUniform2fv(GetUniformHandle(_name).location, 1, &_value[0]); 
     }
 
     void Shader::SetVec2(const std::string &_name, float _x, float _y) const
     { 
-        glUniform2f(glGetUniformLocation(m_programId, _name.c_str()), _x, _y); 
+        glUniform2f(GetUniformHandle(_name).location, _x, _y); 
     }
     
     void Shader::SetVec3(const std::string &_name, const glm::vec3 &_value) const
     { 
-        glUniform3fv(glGetUniformLocation(m_programId, _name.c_str()), 1, &_value[0]); 
+        glUniform3fv(GetUniformHandle(_name).location, 1, &_value[0]); 
     }
 
     void Shader::SetVec3(const std::string &_name, float _x, float _y, float _z) const
     { 
-        glUniform3f(glGetUniformLocation(m_programId, _name.c_str()), _x, _y, _z); 
+        glUniform3f(GetUniformHandle(_name).location, _x, _y, _z); 
     }
     
     void Shader::SetVec4(const std::string &_name, const glm::vec4 &_value) const
     { 
-        glUniform4fv(glGetUniformLocation(m_programId, _name.c_str()), 1, &_value[0]); 
+        glUniform4fv(GetUniformHandle(_name).location, 1, &_value[0]); 
     }
 
     void Shader::SetVec4(const std::string &_name, float _x, float _y, float _z, float _w) 
     { 
-        glUniform4f(glGetUniformLocation(m_programId, _name.c_str()), _x, _y, _z, _w); 
+        glUniform4f(GetUniformHandle(_name).location, _x, _y, _z, _w); 
     }
     
     void Shader::SetMat2(const std::string &_name, const glm::mat2 &_mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(m_programId, _name.c_str()), 1, GL_FALSE, &_mat[0][0]);
+        glUniformMatrix2fv(GetUniformHandle(_name).location, 1, GL_FALSE, &_mat[0][0]);
     }
     
     void Shader::SetMat3(const std::string &_name, const glm::mat3 &_mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(m_programId, _name.c_str()), 1, GL_FALSE, &_mat[0][0]);
+        glUniformMatrix3fv(GetUniformHandle(_name).location, 1, GL_FALSE, &_mat[0][0]);
     }
     
     void Shader::SetMat4(const std::string &_name, const glm::mat4 &_mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(m_programId, _name.c_str()), 1, GL_FALSE, &_mat[0][0]);
+        glUniformMatrix4fv(GetUniformHandle(_name).location, 1, GL_FALSE, &_mat[0][0]);
+    }
+
+    void Shader::SetBool(UniformHandle _handle, bool _value) const
+    {
+        glUniform1i(_handle.location, (int)_value);
+    }
+
+    void Shader::SetInt(UniformHandle _handle, int _value) const
+    {
+        glUniform1i(_handle.location, _value);
+    }
+
+    void Shader::SetFloat(UniformHandle _handle, float _value) const
+    {
+        glUniform1f(_handle.location, _value);
+    }
+
+    void Shader::SetVec2(UniformHandle _handle, const glm::vec2 &_value) const
+    {
+        glUniform2fv(_handle.location, 1, &_value[0]);
+    }
+
+    void Shader::SetVec3(UniformHandle _handle, const glm::vec3 &_value) const
+    {
+        glUniform3fv(_handle.location, 1, &_value[0]);
+    }
+
+    void Shader::SetVec4(UniformHandle _handle, const glm::vec4 &_value) const
+    {
+        glUniform4fv(_handle.location, 1, &_value[0]);
+    }
+
+    void Shader::SetMat2(UniformHandle _handle, const glm::mat2 &_mat) const
+    {
+        glUniformMatrix2fv(_handle.location, 1, GL_FALSE, &_mat[0][0]);
+    }
+
+    void Shader::SetMat3(UniformHandle _handle, const glm::mat3 &_mat) const
+    {
+        glUniformMatrix3fv(_handle.location, 1, GL_FALSE, &_mat[0][0]);
+    }
+
+    void Shader::SetMat4(UniformHandle _handle, const glm::mat4 &_mat) const
+    {
+        glUniformMatrix4fv(_handle.location, 1, GL_FALSE, &_mat[0][0]);
     }
 
     void Shader::CompileShaderFile(const std::string &_filePath, unsigned int &_id)
     {
-        SDL_RWops* shaderFile = SDL_RWFromFile(_filePath.c_str(), "r");
+        VirtualFile shaderFile;
 
-        if (shaderFile == nullptr)
+        if (!shaderFile.Open(_filePath))
             FatalError("Unable to open file \"" + _filePath + "\"");
-        
-        size_t shaderFileLength;// = static_cast<size_t>(SDL_RWsize(shaderFile));
-        void* shaderFileData = SDL_LoadFile_RW(shaderFile, &shaderFileLength, true);
-        std::string shaderFileCode(static_cast<char*>(shaderFileData), shaderFileLength);
+
+        std::string shaderFileCode(shaderFile.GetData(), shaderFile.GetSize());
+        shaderFile.Close();
+
+        // defines have to come after #version
+        if (!m_defines.empty())
+        {
+            size_t insertAt = 0;
+            if (shaderFileCode.compare(0, 8, "#version") == 0)
+            {
+                insertAt = shaderFileCode.find('\n');
+                insertAt = (insertAt == std::string::npos) ? shaderFileCode.size() : insertAt + 1;
+            }
+            shaderFileCode.insert(insertAt, m_defines);
+        }
 
         const char *contentsPtr = shaderFileCode.c_str();
         glShaderSource(_id, 1, &contentsPtr, nullptr);
@@ -179,9 +326,6 @@ namespace Canis
         int success = 0;
         glGetShaderiv(_id, GL_COMPILE_STATUS, &success);
 
-        if (shaderFileData != nullptr)
-            SDL_free(shaderFileData);
-
         if (success == GL_FALSE)
         {
             int maxLength = 0;
@@ -1,9 +1,38 @@
 #pragma once
 #include <string>
+#include <vector>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 namespace Canis
 {
+    // FNV-1a
+    constexpr uint32_t HashUniformName(const char *_name, uint32_t _hash = 2166136261u)
+    {
+        while (*_name != '\0')
+        {
+            _hash ^= (uint8_t)*_name++;
+            _hash *= 16777619u;
+        }
+        return _hash;
+    }
+
+    // uniform name hashed at compile time
+    struct UniformId
+    {
+        uint32_t hash = 0;
+
+        constexpr UniformId() {}
+        consteval explicit UniformId(const char *_name) : hash(HashUniformName(_name)) {}
+        constexpr explicit UniformId(uint32_t _hash) : hash(_hash) {}
+    };
+
+    // uniform location resolved from a shader, only valid for that shader
+    struct UniformHandle
+    {
+        int location = -1;
+    };
+
     class Shader
     {
     public:
@@ -13,6 +42,8 @@ namespace Canis
         void Compile(const std::string &_vertexShaderFilePath, const std::string &_fragmentShaderFilePath);
         void Link();
         void AddAttribute(const std::string &_attributeName);
+        // must be called before Compile, injected after the #version line of both stages
+        void AddDefine(const std::string &_define);
         void Use();
         void UnUse();
         void SetBool(const std::string &_name, bool _value) const;
@@ -28,10 +59,37 @@ namespace Canis
         void SetMat3(const std::string &_name, const glm::mat3 &_mat) const;
         void SetMat4(const std::string &_name, const glm::mat4 &_mat) const;
 
+        // no string allocation and no glGetUniformLocation, names are looked up in the table built by Link
+        UniformHandle GetUniformHandle(UniformId _id) const;
+        UniformHandle GetUniformHandle(const std::string &_name) const;
+        void SetBool(UniformId _id, bool _value) const { SetBool(GetUniformHandle(_id), _value); }
+        void SetInt(UniformId _id, int _value) const { SetInt(GetUniformHandle(_id), _value); }
+        void SetFloat(UniformId _id, float _value) const { SetFloat(GetUniformHandle(_id), _value); }
+        void SetVec2(UniformId _id, const glm::vec2 &_value) const { SetVec2(GetUniformHandle(_id), _value); }
+        void SetVec3(UniformId _id, const glm::vec3 &_value) const { SetVec3(GetUniformHandle(_id), _value); }
+        void SetVec4(UniformId _id, const glm::vec4 &_value) const { SetVec4(GetUniformHandle(_id), _value); }
+        void SetMat2(UniformId _id, const glm::mat2 &_mat) const { SetMat2(GetUniformHandle(_id), _mat); }
+        void SetMat3(UniformId _id, const glm::mat3 &_mat) const { SetMat3(GetUniformHandle(_id), _mat); }
+        void SetMat4(UniformId _id, const glm::mat4 &_mat) const { SetMat4(GetUniformHandle(_id), _mat); }
+
+        void SetBool(UniformHandle _handle, bool _value) const;
+        void SetInt(UniformHandle _handle, int _value) const;
+        void SetFloat(UniformHandle _handle, float _value) const;
+        void SetVec2(UniformHandle _handle, const glm::vec2 &_value) const;
+        void SetVec3(UniformHandle _handle, const glm::vec3 &_value) const;
+        void SetVec4(UniformHandle _handle, const glm::vec4 &_value) const;
+        void SetMat2(UniformHandle _handle, const glm::mat2 &_mat) const;
+        void SetMat3(UniformHandle _handle, const glm::mat3 &_mat) const;
+        void SetMat4(UniformHandle _handle, const glm::mat4 &_mat) const;
+
         bool IsLinked() { return m_isLinked; }
         int GetUniformLocation(const std::string &uniformName);
         int GetProgramID() { return m_programId; }
 
+        // shader compiled with the INSTANCED define, used by World when drawing batches
+        void SetInstancedVariant(Shader *_shader) { m_instancedVariant = _shader; }
+        Shader* GetInstancedVariant() { return m_instancedVariant; }
+
     private:
         bool m_isLinked = false;
 
@@ -41,7 +99,21 @@ namespace Canis
 
         int m_numberOfAttributes = 0;
 
+        struct UniformEntry
+        {
+            uint32_t hash;
+            int location;
+        };
+
+        // sorted by hash, filled once after linking
+        std::vector<UniformEntry> m_uniforms = {};
+
+        std::string m_defines = "";
+        Shader *m_instancedVariant = nullptr;
+
         void CompileShaderFile(const std::string &_filePath, unsigned int &_id);
+        void ReflectUniforms();
+        void BindUniformBlocks();
     };
 
 } // end of Canis namespace
\ No newline at end of file
@@ -0,0 +1,244 @@
+#include "SparseVoxelGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Canis
+{
+    void SparseVoxelGrid::Clear()
+    {
+        m_slots = std::vector<Slot>();
+        m_blocks = std::vector<uint8_t>();
+        m_count = 0;
+    }
+
+    void SparseVoxelGrid::Build(const VoxelGrid &_grid)
+    {
+        Clear();
+
+        glm::ivec3 chunkCount = _grid.GetChunkCount();
+        const int BRICKS_PER_CHUNK = CHUNK_SIZE / BRICK_SIZE;
+        uint8_t brick[BRICK_VOLUME];
+
+        for (int cy = 0; cy < chunkCount.y; cy++)
+        {
+            for (int cx = 0; cx < chunkCount.x; cx++)
+            {
+                for (int cz = 0; cz < chunkCount.z; cz++)
+                {
+                    const uint8_t *chunk = _grid.GetChunkData(glm::ivec3(cx, cy, cz));
+
+                    for (int by = 0; by < BRICKS_PER_CHUNK; by++)
+                    {
+                        for (int bx = 0; bx < BRICKS_PER_CHUNK; bx++)
+                        {
+                            for (int bz = 0; bz < BRICKS_PER_CHUNK; bz++)
+                            {
+                                // rows along z are contiguous in both layouts
+                                for (int y = 0; y < BRICK_SIZE; y++)
+                                    for (int x = 0; x < BRICK_SIZE; x++)
+                                        memcpy(&brick[(y * BRICK_SIZE + x) * BRICK_SIZE],
+                                               &chunk[((by * BRICK_SIZE + y) * CHUNK_SIZE + bx * BRICK_SIZE + x) * CHUNK_SIZE + bz * BRICK_SIZE], BRICK_SIZE);
+
+                                Store(BrickKey(cx * BRICKS_PER_CHUNK + bx, cy * BRICKS_PER_CHUNK + by, cz * BRICKS_PER_CHUNK + bz), brick);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        m_blocks.shrink_to_fit();
+    }
+
+    void SparseVoxelGrid::Set(int _x, int _y, int _z, uint8_t _block)
+    {
+        uint64_t key = BrickKey(_x >> BRICK_SHIFT, _y >> BRICK_SHIFT, _z >> BRICK_SHIFT);
+        uint32_t value = Find(key);
+
+        if (value == EMPTY_VALUE)
+        {
+            if (_block == 0)
+                return;
+
+            value = AddBrick(0);
+            Insert(key).value = value;
+        }
+        else if (value & UNIFORM_BIT)
+        {
+            if ((uint8_t)value == _block)
+                return;
+
+            value = AddBrick((uint8_t)value);
+            Insert(key).value = value;
+        }
+
+        m_blocks[(size_t)value * BRICK_VOLUME + BrickIndex(_x, _y, _z)] = _block;
+    }
+
+    void SparseVoxelGrid::Compact()
+    {
+        std::vector<Slot> slots;
+        std::vector<uint8_t> blocks;
+        slots.swap(m_slots);
+        blocks.swap(m_blocks);
+        m_count = 0;
+
+        for (const Slot &slot : slots)
+        {
+            if (slot.key == EMPTY_KEY)
+                continue;
+
+            if (slot.value & UNIFORM_BIT)
+                Insert(slot.key).value = slot.value;
+            else
+                Store(slot.key, &blocks[(size_t)slot.value * BRICK_VOLUME]);
+        }
+
+        m_blocks.shrink_to_fit();
+    }
+
+    bool SparseVoxelGrid::Raycast(glm::vec3 _origin, glm::vec3 _direction, float _maxDistance, VoxelHit &_hit) const
+    {
+        if (_direction == glm::vec3(0.0f))
+            return false;
+
+        // block (x, y, z) is centered on (x, y, z), moved so it covers x to x + 1
+        glm::vec3 origin = _origin + 0.5f;
+        glm::ivec3 cell = glm::ivec3(glm::floor(origin));
+        glm::ivec3 step;
+        glm::vec3 tMax;
+        glm::vec3 tDelta;
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            step[axis] = (_direction[axis] > 0.0f) ? 1 : ((_direction[axis] < 0.0f) ? -1 : 0);
+
+            if (step[axis] == 0)
+            {
+                tMax[axis] = std::numeric_limits<float>::infinity();
+                tDelta[axis] = std::numeric_limits<float>::infinity();
+                continue;
+            }
+
+            tDelta[axis] = std::abs(1.0f / _direction[axis]);
+            float boundary = (step[axis] > 0) ? (float)cell[axis] + 1.0f : (float)cell[axis];
+            tMax[axis] = (boundary - origin[axis]) / _direction[axis];
+        }
+
+        float distance = 0.0f;
+        glm::ivec3 normal = glm::ivec3(0);
+
+        // moves to the next block along the ray, false once that is past _maxDistance
+        auto advance = [&]()
+        {
+            int axis = (tMax.x < tMax.y) ? ((tMax.x < tMax.z) ? 0 : 2) : ((tMax.y < tMax.z) ? 1 : 2);
+
+            distance = tMax[axis];
+            if (distance > _maxDistance)
+                return false;
+
+            cell[axis] += step[axis];
+            tMax[axis] += tDelta[axis];
+            normal = glm::ivec3(0);
+            normal[axis] = -step[axis];
+            return true;
+        };
+
+        while (true)
+        {
+            glm::ivec3 brick = glm::ivec3(cell.x >> BRICK_SHIFT, cell.y >> BRICK_SHIFT, cell.z >> BRICK_SHIFT);
+            uint32_t value = Find(BrickKey(brick.x, brick.y, brick.z));
+
+            if (value == EMPTY_VALUE)
+            {
+                // the whole brick is air, only the stepping is done until the ray leaves it
+                bool inside = true;
+                while (inside)
+                {
+                    if (!advance())
+                        return false;
+                    inside = (cell.x >> BRICK_SHIFT) == brick.x && (cell.y >> BRICK_SHIFT) == brick.y && (cell.z >> BRICK_SHIFT) == brick.z;
+                }
+                continue;
+            }
+
+            uint8_t id = (value & UNIFORM_BIT) ? (uint8_t)value : m_blocks[(size_t)value * BRICK_VOLUME + BrickIndex(cell.x, cell.y, cell.z)];
+
+            if (id != 0)
+            {
+                _hit.block = cell;
+                _hit.normal = normal;
+                _hit.distance = distance;
+                _hit.id = id;
+                return true;
+            }
+
+            if (!advance())
+                return false;
+        }
+    }
+
+    SparseVoxelGrid::Slot &SparseVoxelGrid::Insert(uint64_t _key)
+    {
+        // kept at most half full so a miss ends quickly
+        if ((m_count + 1) * 2 > m_slots.size())
+        {
+            std::vector<Slot> slots(std::max<size_t>(64, m_slots.size() * 2));
+            size_t mask = slots.size() - 1;
+
+            for (const Slot &slot : m_slots)
+            {
+                if (slot.key == EMPTY_KEY)
+                    continue;
+
+                size_t index = HashKey(slot.key) & mask;
+                while (slots[index].key != EMPTY_KEY)
+                    index = (index + 1) & mask;
+                slots[index] = slot;
+            }
+
+            m_slots.swap(slots);
+        }
+
+        size_t mask = m_slots.size() - 1;
+        size_t index = HashKey(_key) & mask;
+        while (m_slots[index].key != _key && m_slots[index].key != EMPTY_KEY)
+            index = (index + 1) & mask;
+
+        if (m_slots[index].key == EMPTY_KEY)
+        {
+            m_slots[index].key = _key;
+            m_count++;
+        }
+
+        return m_slots[index];
+    }
+
+    uint32_t SparseVoxelGrid::AddBrick(uint8_t _block)
+    {
+        uint32_t brick = m_blocks.size() / BRICK_VOLUME;
+        m_blocks.resize(m_blocks.size() + BRICK_VOLUME, _block);
+        return brick;
+    }
+
+    void SparseVoxelGrid::Store(uint64_t _key, const uint8_t *_blocks)
+    {
+        bool uniform = true;
+        for (int i = 1; i < BRICK_VOLUME && uniform; i++)
+            uniform = _blocks[i] == _blocks[0];
+
+        if (uniform)
+        {
+            if (_blocks[0] != 0)
+                Insert(_key).value = UNIFORM_BIT | _blocks[0];
+            return;
+        }
+
+        uint32_t brick = AddBrick(0);
+        memcpy(&m_blocks[(size_t)brick * BRICK_VOLUME], _blocks, BRICK_VOLUME);
+        Insert(_key).value = brick;
+    }
+} // end of Canis namespace
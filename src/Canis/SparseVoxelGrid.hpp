@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "VoxelGrid.hpp"
+
+namespace Canis
+{
+    struct VoxelHit
+    {
+        glm::ivec3 block = glm::ivec3(0);  // the block the ray stopped in
+        glm::ivec3 normal = glm::ivec3(0); // face it came through, zero when it started inside
+        float distance = 0.0f;
+        uint8_t id = 0;
+    };
+
+    // block ids in 8x8x8 bricks behind a hash of brick coordinates, air bricks are not stored
+    // a brick of one block id is only an entry in the hash, so solid ground costs as little as air
+    // not bounded, coordinates fit in 24 bits each
+    class SparseVoxelGrid
+    {
+    public:
+        static const int BRICK_SHIFT = 3;
+        static const int BRICK_SIZE = 1 << BRICK_SHIFT;
+        static const int BRICK_VOLUME = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+
+        void Clear();
+
+        // every brick of _grid that is not all air
+        void Build(const VoxelGrid &_grid);
+
+        // returns 0 (air) where no brick is stored
+        uint8_t Get(int _x, int _y, int _z) const
+        {
+            uint32_t value = Find(BrickKey(_x >> BRICK_SHIFT, _y >> BRICK_SHIFT, _z >> BRICK_SHIFT));
+
+            if (value == EMPTY_VALUE)
+                return 0;
+            if (value & UNIFORM_BIT)
+                return (uint8_t)value;
+
+            return m_blocks[(size_t)value * BRICK_VOLUME + BrickIndex(_x, _y, _z)];
+        }
+
+        // stores a brick on the first block that is not air, bricks that turn back to air stay until Compact
+        void Set(int _x, int _y, int _z, uint8_t _block);
+
+        // drops air bricks and folds bricks of one block id into their hash entry
+        void Compact();
+
+        // walks the blocks along the ray and skips missing bricks without looking at their blocks
+        // _direction does not have to be normalized, distances are in its length
+        bool Raycast(glm::vec3 _origin, glm::vec3 _direction, float _maxDistance, VoxelHit &_hit) const;
+
+        // calls _visit(brick, blocks, id) for every stored brick in no particular order
+        // blocks is nullptr for a brick of one id, brick is in brick coordinates
+        template <typename Visit>
+        void ForEachBrick(Visit _visit) const
+        {
+            for (const Slot &slot : m_slots)
+            {
+                if (slot.key == EMPTY_KEY)
+                    continue;
+
+                glm::ivec3 brick = UnpackKey(slot.key);
+                if (slot.value & UNIFORM_BIT)
+                    _visit(brick, (const uint8_t *)nullptr, (uint8_t)slot.value);
+                else
+                    _visit(brick, &m_blocks[(size_t)slot.value * BRICK_VOLUME], (uint8_t)0);
+            }
+        }
+
+        size_t GetBrickCount() const { return m_count; }
+        size_t GetUniformBrickCount() const { return m_count - m_blocks.size() / BRICK_VOLUME; }
+        // the hash and every stored brick
+        size_t GetMemoryUsage() const { return m_slots.capacity() * sizeof(Slot) + m_blocks.capacity(); }
+
+    private:
+        static const uint64_t EMPTY_KEY = ~0ull;
+        static const uint32_t EMPTY_VALUE = ~0u;
+        static const uint32_t UNIFORM_BIT = 1u << 31; // the low byte is the id of every block in the brick
+
+        struct Slot
+        {
+            uint64_t key = EMPTY_KEY;
+            uint32_t value = EMPTY_VALUE; // brick index into m_blocks or UNIFORM_BIT | id
+        };
+
+        static uint64_t BrickKey(int _bx, int _by, int _bz)
+        {
+            const uint64_t MASK = (1u << 21) - 1;
+            return ((uint64_t)(_bx & MASK) << 42) | ((uint64_t)(_by & MASK) << 21) | (uint64_t)(_bz & MASK);
+        }
+
+        static glm::ivec3 UnpackKey(uint64_t _key)
+        {
+            // shifted up then back down to bring back the sign
+            auto unpack = [](uint64_t _bits) { return (int)((int64_t)(_bits << 43) >> 43); };
+            return glm::ivec3(unpack(_key >> 42), unpack(_key >> 21), unpack(_key));
+        }
+
+        static int BrickIndex(int _x, int _y, int _z)
+        {
+            const int MASK = BRICK_SIZE - 1;
+            return (((_y & MASK) << BRICK_SHIFT | (_x & MASK)) << BRICK_SHIFT) | (_z & MASK);
+        }
+
+        static size_t HashKey(uint64_t _key)
+        {
+            _key ^= _key >> 33;
+            _key *= 0xff51afd7ed558ccdull;
+            _key ^= _key >> 33;
+            return (size_t)_key;
+        }
+
+        uint32_t Find(uint64_t _key) const
+        {
+            if (m_slots.empty())
+                return EMPTY_VALUE;
+
+            size_t mask = m_slots.size() - 1;
+            for (size_t slot = HashKey(_key) & mask;; slot = (slot + 1) & mask)
+            {
+                if (m_slots[slot].key == _key)
+                    return m_slots[slot].value;
+                if (m_slots[slot].key == EMPTY_KEY)
+                    return EMPTY_VALUE;
+            }
+        }
+
+        // the slot of _key, a new one when it is missing
+        Slot &Insert(uint64_t _key);
+        // a brick filled with _block at the end of m_blocks
+        uint32_t AddBrick(uint8_t _block);
+        void Store(uint64_t _key, const uint8_t *_blocks);
+
+        std::vector<Slot> m_slots = {}; // open addressed, the size is a power of two
+        std::vector<uint8_t> m_blocks = {};
+        size_t m_count = 0;
+    };
+} // end of Canis namespace
@@ -0,0 +1,93 @@
+#include "Task.hpp"
+#include "Debug.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Canis
+{
+    void TaskScheduler::Spawn(Task<void> _task)
+    {
+        std::coroutine_handle<> handle = _task.GetHandle();
+        m_running.push_back(std::move(_task));
+        handle.resume();
+    }
+
+    void TaskScheduler::Update(double _budgetSeconds)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        std::deque<std::coroutine_handle<>> ready;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ready.swap(m_ready);
+        }
+
+        while (!ready.empty())
+        {
+            ready.front().resume();
+            ready.pop_front();
+
+            if (_budgetSeconds > 0.0 && std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() > _budgetSeconds)
+                break;
+        }
+
+        // over budget, the rest goes first next frame
+        if (!ready.empty())
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_ready.insert(m_ready.begin(), ready.begin(), ready.end());
+        }
+
+        for (Task<void> &task : m_running)
+        {
+            if (!task.IsDone())
+                continue;
+
+            try
+            {
+                task.GetResult();
+            }
+            catch (const std::exception &exception)
+            {
+                Error(std::string("Task failed: ") + exception.what());
+            }
+            catch (...)
+            {
+                Error("Task failed");
+            }
+        }
+
+        m_running.erase(std::remove_if(m_running.begin(), m_running.end(), [](const Task<void> &_task) { return _task.IsDone(); }), m_running.end());
+    }
+
+    void TaskScheduler::Schedule(std::coroutine_handle<> _handle)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_ready.push_back(_handle);
+    }
+
+    TaskScheduler &GetTaskScheduler()
+    {
+        static TaskScheduler taskScheduler;
+        return taskScheduler;
+    }
+
+    Task<std::unique_ptr<VirtualFile>> ReadFileAsync(std::string _path)
+    {
+        auto read = [&_path]()
+        {
+            std::unique_ptr<VirtualFile> file = std::make_unique<VirtualFile>();
+            if (!file->Open(_path))
+                return std::unique_ptr<VirtualFile>();
+
+            volatile char touched = 0;
+            for (size_t i = 0; i < file->GetSize(); i += 4096)
+                touched = touched + file->GetData()[i];
+
+            return file;
+        };
+
+        co_return co_await RunOnPool(read);
+    }
+} // end of Canis namespace
@@ -0,0 +1,222 @@
+#pragma once
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AssetPack.hpp"
+#include "ThreadPool.hpp"
+
+namespace Canis
+{
+    template <typename T = void>
+    class Task;
+
+    // what every task promise shares, the coroutine waiting on the task is resumed straight from final_suspend
+    struct TaskPromiseBase
+    {
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> _handle) noexcept
+            {
+                return _handle.promise().continuation;
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+        std::exception_ptr exception = nullptr;
+
+        // a task does nothing until it is awaited or spawned
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    template <typename T>
+    struct TaskPromise : TaskPromiseBase
+    {
+        std::optional<T> value = std::nullopt;
+
+        Task<T> get_return_object();
+        void return_value(T _value) { value = std::move(_value); }
+    };
+
+    template <>
+    struct TaskPromise<void> : TaskPromiseBase
+    {
+        Task<void> get_return_object();
+        void return_void() {}
+    };
+
+    // a coroutine returning T, co_await it from another task or hand a Task<void> to TaskScheduler::Spawn
+    // anything thrown inside is rethrown to whoever awaits it
+    template <typename T>
+    class Task
+    {
+    public:
+        using promise_type = TaskPromise<T>;
+
+        Task() {}
+        explicit Task(std::coroutine_handle<promise_type> _handle) : m_handle(_handle) {}
+        ~Task()
+        {
+            if (m_handle)
+                m_handle.destroy();
+        }
+
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        Task(Task &&_other) noexcept : m_handle(std::exchange(_other.m_handle, nullptr)) {}
+        Task &operator=(Task &&_other) noexcept
+        {
+            if (this != &_other)
+            {
+                if (m_handle)
+                    m_handle.destroy();
+                m_handle = std::exchange(_other.m_handle, nullptr);
+            }
+            return *this;
+        }
+
+        bool IsDone() const { return !m_handle || m_handle.done(); }
+
+        bool await_ready() const noexcept { return IsDone(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> _awaiting) noexcept
+        {
+            m_handle.promise().continuation = _awaiting;
+            return m_handle;
+        }
+
+        T await_resume() { return GetResult(); }
+
+        // only once the task is done
+        T GetResult()
+        {
+            if (m_handle.promise().exception)
+                std::rethrow_exception(m_handle.promise().exception);
+
+            if constexpr (!std::is_void_v<T>)
+                return std::move(*m_handle.promise().value);
+        }
+
+        std::coroutine_handle<promise_type> GetHandle() const { return m_handle; }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle = nullptr;
+    };
+
+    template <typename T>
+    Task<T> TaskPromise<T>::get_return_object()
+    {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> TaskPromise<void>::get_return_object()
+    {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+
+    // runs coroutines on the gl thread, the main loop calls Update once per frame
+    class TaskScheduler
+    {
+    public:
+        // runs _task on the calling thread up to its first co_await and keeps it alive until it finishes
+        void Spawn(Task<void> _task);
+
+        // resumes what was woken before this call, newer wake ups wait for the next frame
+        // stops after _budgetSeconds so a frame never does all the queued work, 0 has no limit
+        void Update(double _budgetSeconds = 0.004);
+
+        // wakes _handle on the next Update, callable from any thread
+        void Schedule(std::coroutine_handle<> _handle);
+
+        // spawned tasks that have not finished
+        size_t GetRunningCount() const { return m_running.size(); }
+
+    private:
+        std::mutex m_mutex;
+        std::deque<std::coroutine_handle<>> m_ready = {};
+        std::vector<Task<void>> m_running = {};
+    };
+
+    extern TaskScheduler &GetTaskScheduler();
+
+    // co_await NextFrame() continues the task on the gl thread in the next Update
+    struct NextFrame
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> _handle) const { GetTaskScheduler().Schedule(_handle); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await RunOnPool(job) runs job on the thread pool and continues the task on the gl thread with its result
+    template <typename Job>
+    class PoolAwaiter
+    {
+    public:
+        using Result = std::invoke_result_t<Job &>;
+
+        explicit PoolAwaiter(Job &_job) : m_job(&_job) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> _handle)
+        {
+            // the awaiter and the job live in the suspended coroutine's frame until the handle is resumed
+            GetThreadPool().Submit([this, _handle]()
+            {
+                try
+                {
+                    if constexpr (std::is_void_v<Result>)
+                        (*m_job)();
+                    else
+                        m_result.emplace((*m_job)());
+                }
+                catch (...)
+                {
+                    m_exception = std::current_exception();
+                }
+
+                GetTaskScheduler().Schedule(_handle);
+            });
+        }
+
+        Result await_resume()
+        {
+            if (m_exception)
+                std::rethrow_exception(m_exception);
+
+            if constexpr (!std::is_void_v<Result>)
+                return std::move(*m_result);
+        }
+
+    private:
+        Job *m_job = nullptr;
+        std::conditional_t<std::is_void_v<Result>, bool, std::optional<Result>> m_result = {};
+        std::exception_ptr m_exception = nullptr;
+    };
+
+    // the job is taken by reference so it can not be a temporary, gcc 12 destroys a lambda
+    // created inside a co_await expression twice, name it first: auto job = [&]() { ... }; co_await RunOnPool(job);
+    template <typename Job>
+    PoolAwaiter<Job> RunOnPool(Job &_job)
+    {
+        return PoolAwaiter<Job>(_job);
+    }
+
+    // opens the file on the thread pool and touches every page there so reading it on the gl thread does not fault
+    // nullptr when the file can not be opened
+    extern Task<std::unique_ptr<VirtualFile>> ReadFileAsync(std::string _path);
+} // end of Canis namespace
@@ -0,0 +1,267 @@
+#include "TerrainGenerator.hpp"
+#include "Canis.hpp"
+#include "Debug.hpp"
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace Canis
+{
+    namespace
+    {
+        // every use of the random numbers gets its own stream so they do not line up
+        const uint32_t DIRT_STREAM = 1;
+        const uint32_t VEGETATION_STREAM = 2;
+        const uint32_t HEIGHT_STREAM = 3; // the octaves use the streams from here on
+
+        const int MAX_COLUMNS = CHUNK_PADDED_SIZE * CHUNK_PADDED_SIZE;
+
+        inline uint32_t Mix(uint32_t _hash)
+        {
+            _hash ^= _hash >> 16;
+            _hash *= 0x7feb352du;
+            _hash ^= _hash >> 15;
+            _hash *= 0x846ca68bu;
+            _hash ^= _hash >> 16;
+            return _hash;
+        }
+
+        inline uint32_t NoiseSeed(uint64_t _seed, uint32_t _stream)
+        {
+            return Mix((uint32_t)_seed ^ Mix((uint32_t)(_seed >> 32) + _stream * 0x9e3779b9u));
+        }
+
+        inline uint32_t HashLattice(uint32_t _seed, int _x, int _z)
+        {
+            return Mix(_seed ^ ((uint32_t)_x * 0x9e3779b1u + (uint32_t)_z * 0x85ebca77u));
+        }
+
+        // floor without the libm call so the rows vectorize
+        inline int FastFloor(float _value)
+        {
+            int truncated = (int)_value;
+            return truncated - (_value < (float)truncated);
+        }
+
+        inline float Fade(float _t)
+        {
+            return _t * _t * _t * (_t * (_t * 6.0f - 15.0f) + 10.0f);
+        }
+
+        // the gradient is the hash split into two numbers from -1 to 1
+        inline float Gradient(uint32_t _hash, float _dx, float _dz)
+        {
+            float gx = (float)(int)(_hash & 0xffff) * (2.0f / 65535.0f) - 1.0f;
+            float gz = (float)(int)(_hash >> 16) * (2.0f / 65535.0f) - 1.0f;
+            return gx * _dx + gz * _dz;
+        }
+
+        inline float Lattice(uint32_t _hash)
+        {
+            return (float)(int)(_hash >> 8) * (2.0f / 16777215.0f) - 1.0f;
+        }
+
+        // everything a column of terrain needs, _size x _size columns with z fastest
+        struct Columns
+        {
+            int size = 0;
+            int height[MAX_COLUMNS];
+            int dirtDepth[MAX_COLUMNS];
+            uint8_t vegetation[MAX_COLUMNS];
+        };
+
+        void GenerateColumns(const TerrainSettings &_settings, int _x, int _z, int _size, Columns &_columns)
+        {
+            float noise[CHUNK_PADDED_SIZE];
+            float surface[CHUNK_PADDED_SIZE];
+
+            _columns.size = _size;
+
+            for (int x = 0; x < _size; x++)
+            {
+                for (int z = 0; z < _size; z++)
+                    surface[z] = 0.0f;
+
+                float frequency = _settings.hillFrequency;
+                float height = _settings.hillHeight;
+
+                for (int octave = 0; octave < _settings.octaves; octave++)
+                {
+                    GradientNoiseRow(_settings.seed, HEIGHT_STREAM + octave, (float)(_x + x), (float)_z, frequency, _size, noise);
+                    for (int z = 0; z < _size; z++)
+                        surface[z] += noise[z] * height;
+
+                    frequency *= 2.0f;
+                    height *= 0.5f;
+                }
+
+                for (int z = 0; z < _size; z++)
+                    _columns.height[x * _size + z] = _settings.baseHeight + FastFloor(surface[z]);
+
+                ValueNoiseRow(_settings.seed, DIRT_STREAM, (float)(_x + x), (float)_z, 0.1f, _size, noise);
+                for (int z = 0; z < _size; z++)
+                    _columns.dirtDepth[x * _size + z] = _settings.dirtDepth + FastFloor((noise[z] + 1.0f) * 1.49f);
+
+                for (int z = 0; z < _size; z++)
+                {
+                    int column = x * _size + z;
+                    float chance = RandomFloat(_settings.seed, _x + x, _columns.height[column] + 1, _z + z, VEGETATION_STREAM);
+
+                    _columns.vegetation[column] = 0;
+                    if (chance < _settings.grassChance)
+                        _columns.vegetation[column] = _settings.grassBlock;
+                    else if (chance < _settings.grassChance + _settings.flowerChance)
+                        _columns.vegetation[column] = _settings.flowerBlock;
+                }
+            }
+        }
+
+        inline uint8_t BlockAt(const TerrainSettings &_settings, const Columns &_columns, int _column, int _y)
+        {
+            int height = _columns.height[_column];
+
+            if (_y > height + 1)
+                return 0;
+            if (_y == height + 1)
+                return _columns.vegetation[_column];
+            if (_y > height - _columns.dirtDepth[_column])
+                return _settings.dirtBlock;
+            return _settings.stoneBlock;
+        }
+
+        void FillChunk(const TerrainSettings &_settings, const Columns &_columns, int _chunkY, uint8_t *_blocks)
+        {
+            int originY = _chunkY * CHUNK_SIZE;
+
+            for (int y = 0; y < CHUNK_SIZE; y++)
+                for (int x = 0; x < CHUNK_SIZE; x++)
+                    for (int z = 0; z < CHUNK_SIZE; z++)
+                        _blocks[(y * CHUNK_SIZE + x) * CHUNK_SIZE + z] = BlockAt(_settings, _columns, x * CHUNK_SIZE + z, originY + y);
+        }
+    }
+
+    uint32_t RandomBits(uint64_t _seed, int _x, int _y, int _z, uint32_t _stream)
+    {
+        uint32_t hash = NoiseSeed(_seed, _stream);
+        hash = Mix(hash ^ (uint32_t)_x * 0x9e3779b1u);
+        hash = Mix(hash ^ (uint32_t)_y * 0x85ebca77u);
+        hash = Mix(hash ^ (uint32_t)_z * 0xc2b2ae3du);
+        return hash;
+    }
+
+    uint64_t GetWorldSeed()
+    {
+        static uint64_t seed = []()
+        {
+            if (GetConfig().overrideSeed)
+                return (uint64_t)GetConfig().seed;
+
+            // folded to the size of the seed in project.canis so it can be written there
+            uint64_t clock = std::chrono::system_clock::now().time_since_epoch().count();
+            uint32_t clockSeed = (uint32_t)(clock ^ (clock >> 32));
+            Log("World seed " + std::to_string(clockSeed) + ", set override_seed true and seed " + std::to_string(clockSeed) + " in project.canis to get this world again");
+            return (uint64_t)clockSeed;
+        }();
+
+        return seed;
+    }
+
+    void GradientNoiseRow(uint64_t _seed, uint32_t _stream, float _x, float _z, float _frequency, int _count, float *_values)
+    {
+        uint32_t seed = NoiseSeed(_seed, _stream);
+
+        float x = _x * _frequency;
+        int x0 = FastFloor(x);
+        float dx = x - (float)x0;
+        float u = Fade(dx);
+
+        for (int i = 0; i < _count; i++)
+        {
+            float z = (_z + (float)i) * _frequency;
+            int z0 = FastFloor(z);
+            float dz = z - (float)z0;
+            float v = Fade(dz);
+
+            float n00 = Gradient(HashLattice(seed, x0, z0), dx, dz);
+            float n10 = Gradient(HashLattice(seed, x0 + 1, z0), dx - 1.0f, dz);
+            float n01 = Gradient(HashLattice(seed, x0, z0 + 1), dx, dz - 1.0f);
+            float n11 = Gradient(HashLattice(seed, x0 + 1, z0 + 1), dx - 1.0f, dz - 1.0f);
+
+            float edge0 = n00 + u * (n10 - n00);
+            float edge1 = n01 + u * (n11 - n01);
+            _values[i] = edge0 + v * (edge1 - edge0);
+        }
+    }
+
+    void ValueNoiseRow(uint64_t _seed, uint32_t _stream, float _x, float _z, float _frequency, int _count, float *_values)
+    {
+        uint32_t seed = NoiseSeed(_seed, _stream);
+
+        float x = _x * _frequency;
+        int x0 = FastFloor(x);
+        float u = Fade(x - (float)x0);
+
+        for (int i = 0; i < _count; i++)
+        {
+            float z = (_z + (float)i) * _frequency;
+            int z0 = FastFloor(z);
+            float v = Fade(z - (float)z0);
+
+            float n00 = Lattice(HashLattice(seed, x0, z0));
+            float n10 = Lattice(HashLattice(seed, x0 + 1, z0));
+            float n01 = Lattice(HashLattice(seed, x0, z0 + 1));
+            float n11 = Lattice(HashLattice(seed, x0 + 1, z0 + 1));
+
+            float edge0 = n00 + u * (n10 - n00);
+            float edge1 = n01 + u * (n11 - n01);
+            _values[i] = edge0 + v * (edge1 - edge0);
+        }
+    }
+
+    void GenerateChunk(const TerrainSettings &_settings, glm::ivec3 _chunk, uint8_t *_blocks)
+    {
+        Columns columns;
+        GenerateColumns(_settings, _chunk.x * CHUNK_SIZE, _chunk.z * CHUNK_SIZE, CHUNK_SIZE, columns);
+        FillChunk(_settings, columns, _chunk.y, _blocks);
+    }
+
+    void GeneratePaddedChunk(const TerrainSettings &_settings, glm::ivec3 _chunk, uint8_t *_paddedBlocks)
+    {
+        glm::ivec3 origin = _chunk * CHUNK_SIZE;
+
+        Columns columns;
+        GenerateColumns(_settings, origin.x - 1, origin.z - 1, CHUNK_PADDED_SIZE, columns);
+
+        for (int y = -1; y <= CHUNK_SIZE; y++)
+            for (int x = -1; x <= CHUNK_SIZE; x++)
+                for (int z = -1; z <= CHUNK_SIZE; z++)
+                    _paddedBlocks[PaddedChunkIndex(x, y, z)] = BlockAt(_settings, columns, (x + 1) * CHUNK_PADDED_SIZE + (z + 1), origin.y + y);
+    }
+
+    void GenerateTerrain(const TerrainSettings &_settings, VoxelGrid &_grid, ThreadPool &_pool)
+    {
+        glm::ivec3 chunkCount = _grid.GetChunkCount();
+        std::vector<std::future<void>> jobs;
+
+        // the columns are shared by every chunk above each other
+        for (int cx = 0; cx < chunkCount.x; cx++)
+        {
+            for (int cz = 0; cz < chunkCount.z; cz++)
+            {
+                jobs.push_back(_pool.Submit([&_settings, &_grid, cx, cz, chunkCount]()
+                {
+                    Columns columns;
+                    GenerateColumns(_settings, cx * CHUNK_SIZE, cz * CHUNK_SIZE, CHUNK_SIZE, columns);
+
+                    for (int cy = 0; cy < chunkCount.y; cy++)
+                        FillChunk(_settings, columns, cy, _grid.GetChunkData(glm::ivec3(cx, cy, cz)));
+                }));
+            }
+        }
+
+        for (std::future<void> &job : jobs)
+            job.get();
+    }
+} // end of Canis namespace
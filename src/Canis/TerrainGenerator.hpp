@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "ThreadPool.hpp"
+#include "VoxelGrid.hpp"
+
+namespace Canis
+{
+    // counter based random numbers, the same seed, cell and stream give the same bits on any thread in any order
+    extern uint32_t RandomBits(uint64_t _seed, int _x, int _y, int _z, uint32_t _stream);
+
+    // from 0 up to but not including 1
+    inline float RandomFloat(uint64_t _seed, int _x, int _y, int _z, uint32_t _stream)
+    {
+        return (RandomBits(_seed, _x, _y, _z, _stream) >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // the seed of project.canis when override_seed is true, otherwise one from the clock that is logged on the first call
+    extern uint64_t GetWorldSeed();
+
+    // _count samples of 2d noise at (_x, _z), (_x, _z + 1) ... scaled by _frequency, roughly from -1 to 1
+    // the samples are independent and branch free so the loops vectorize
+    extern void GradientNoiseRow(uint64_t _seed, uint32_t _stream, float _x, float _z, float _frequency, int _count, float *_values);
+    extern void ValueNoiseRow(uint64_t _seed, uint32_t _stream, float _x, float _z, float _frequency, int _count, float *_values);
+
+    struct TerrainSettings
+    {
+        uint64_t seed = 0;
+        int baseHeight = 64;         // average height of the surface
+        float hillHeight = 24.0f;    // the surface moves up to this far up and down
+        float hillFrequency = 0.01f; // of the first octave, every octave doubles it at half the height
+        int octaves = 4;
+        int dirtDepth = 3;           // dirt under the surface, value noise adds up to 2 more
+        float grassChance = 0.2f;    // of grass on a surface block
+        float flowerChance = 0.05f;  // of a flower on a surface block without grass
+        uint8_t stoneBlock = 5;
+        uint8_t dirtBlock = 4;
+        uint8_t grassBlock = 2;
+        uint8_t flowerBlock = 6;
+    };
+
+    // fills a chunk in VoxelGrid's CHUNK_VOLUME layout, every block depends only on the settings and its position
+    extern void GenerateChunk(const TerrainSettings &_settings, glm::ivec3 _chunk, uint8_t *_blocks);
+
+    // the same blocks with the one block border BuildChunkMesh needs, a ChunkStreamer fill
+    extern void GeneratePaddedChunk(const TerrainSettings &_settings, glm::ivec3 _chunk, uint8_t *_paddedBlocks);
+
+    // every chunk of _grid with a job per chunk column, the blocks are the same for any number of threads
+    extern void GenerateTerrain(const TerrainSettings &_settings, VoxelGrid &_grid, ThreadPool &_pool);
+} // end of Canis namespace
@@ -0,0 +1,216 @@
+#include "TextureFile.hpp"
+#include "AssetPack.hpp"
+#include "Debug.hpp"
+
+#include <stb_image.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Canis
+{
+    namespace
+    {
+        const char TEXTURE_MAGIC[4] = {'C', 'T', 'E', 'X'};
+
+        size_t LevelSize(int _width, int _height, int _channels)
+        {
+            return (size_t)_width * _height * _channels;
+        }
+
+        // fills levels 1 to n from level 0 and the sizes of every level
+        void SetLevels(TextureData &_texture, const uint8_t *_base, const uint64_t *_offsets)
+        {
+            int width = _texture.width;
+            int height = _texture.height;
+
+            for (int i = 0; i < _texture.levelCount; i++)
+            {
+                _texture.levels[i].pixels = _base + _offsets[i];
+                _texture.levels[i].width = width;
+                _texture.levels[i].height = height;
+                width = std::max(1, width / 2);
+                height = std::max(1, height / 2);
+            }
+        }
+
+        bool OpenTextureCache(const std::string &_imagePath, int _channels, bool _flip, TextureData &_texture)
+        {
+            if (!_texture.file.Open(GetTextureCachePath(_imagePath)))
+                return false;
+
+            const TextureFileHeader *header = (const TextureFileHeader *)_texture.file.GetData();
+            size_t size = _texture.file.GetSize();
+
+            if (size < sizeof(TextureFileHeader) || memcmp(header->magic, TEXTURE_MAGIC, 4) != 0 || header->version != TEXTURE_FILE_VERSION)
+                return false;
+
+            if (header->requestedChannels != (uint32_t)_channels || header->flipped != (uint32_t)_flip)
+                return false;
+
+            uint64_t sourceSize = 0;
+            int64_t sourceTime = 0;
+            // a cache without its image is still used
+            if (GetFileStamp(_imagePath, sourceSize, sourceTime) && (sourceSize != header->sourceSize || sourceTime != header->sourceTime))
+                return false;
+
+            if (header->levelCount == 0 || header->levelCount > MAX_TEXTURE_LEVELS || header->channels == 0 || header->channels > 4)
+                return false;
+
+            _texture.width = header->width;
+            _texture.height = header->height;
+            _texture.channels = header->channels;
+            _texture.levelCount = header->levelCount;
+            SetLevels(_texture, (const uint8_t *)_texture.file.GetData(), header->levelOffsets);
+
+            for (int i = 0; i < _texture.levelCount; i++)
+                if (header->levelOffsets[i] + LevelSize(_texture.levels[i].width, _texture.levels[i].height, _texture.channels) > size)
+                    return false;
+
+            _texture.fromCache = true;
+            return true;
+        }
+
+        bool DecodeTexture(const std::string &_imagePath, int _channels, bool _flip, TextureData &_texture)
+        {
+            VirtualFile file;
+            if (!file.Open(_imagePath))
+                return false;
+
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+            stbi_uc *pixels = stbi_load_from_memory((const stbi_uc *)file.GetData(), (int)file.GetSize(), &width, &height, &channels, _channels);
+            if (pixels == nullptr)
+                return false;
+
+            if (_channels != 0)
+                channels = _channels;
+
+            _texture.width = width;
+            _texture.height = height;
+            _texture.channels = channels;
+            _texture.levelCount = 1;
+
+            while (_texture.levelCount < MAX_TEXTURE_LEVELS && (width > 1 || height > 1))
+            {
+                width = std::max(1, width / 2);
+                height = std::max(1, height / 2);
+                _texture.levelCount++;
+            }
+
+            // every level back to back with the alignment the .ctex uses, so the file is one write
+            uint64_t offsets[MAX_TEXTURE_LEVELS] = {};
+            uint64_t total = 0;
+            width = _texture.width;
+            height = _texture.height;
+
+            for (int i = 0; i < _texture.levelCount; i++)
+            {
+                offsets[i] = total;
+                total = AlignBlob(total + LevelSize(width, height, channels));
+                width = std::max(1, width / 2);
+                height = std::max(1, height / 2);
+            }
+
+            _texture.parsedPixels.resize(total);
+            uint8_t *base = _texture.parsedPixels.data();
+
+            // flipped while copying, stb's global flip setting is never touched so workers can run this
+            size_t rowSize = (size_t)_texture.width * channels;
+            for (int y = 0; y < _texture.height; y++)
+            {
+                int sourceRow = _flip ? _texture.height - 1 - y : y;
+                memcpy(base + y * rowSize, pixels + sourceRow * rowSize, rowSize);
+            }
+            stbi_image_free(pixels);
+
+            SetLevels(_texture, base, offsets);
+
+            for (int i = 1; i < _texture.levelCount; i++)
+            {
+                const TextureLevel &source = _texture.levels[i - 1];
+                DownsampleLevel(source.pixels, source.width, source.height, channels, base + offsets[i]);
+            }
+
+            _texture.fromCache = false;
+            return true;
+        }
+
+        void SaveTextureCache(const std::string &_imagePath, int _channels, bool _flip, const TextureData &_texture)
+        {
+            TextureFileHeader header = {};
+            memcpy(header.magic, TEXTURE_MAGIC, 4);
+            header.version = TEXTURE_FILE_VERSION;
+            GetFileStamp(_imagePath, header.sourceSize, header.sourceTime);
+            header.requestedChannels = _channels;
+            header.flipped = _flip;
+            header.width = _texture.width;
+            header.height = _texture.height;
+            header.channels = _texture.channels;
+            header.levelCount = _texture.levelCount;
+
+            uint64_t levelStart = AlignBlob(sizeof(TextureFileHeader));
+            for (int i = 0; i < _texture.levelCount; i++)
+                header.levelOffsets[i] = levelStart + (_texture.levels[i].pixels - _texture.parsedPixels.data());
+
+            auto write = [&](std::ostream &_file)
+            {
+                _file.write((const char *)&header, sizeof(header));
+                WritePadding(_file, levelStart);
+                _file.write((const char *)_texture.parsedPixels.data(), _texture.parsedPixels.size());
+            };
+
+            std::string path = GetTextureCachePath(_imagePath);
+            if (!WriteFileAtomically(path, write))
+                Warning("Can not write texture cache " + path);
+        }
+    }
+
+    std::string GetTextureCachePath(const std::string &_imagePath)
+    {
+        return _imagePath + ".ctex";
+    }
+
+    bool LoadTextureData(const std::string &_imagePath, int _channels, bool _flip, TextureData &_texture, bool _useCache)
+    {
+        if (_useCache && OpenTextureCache(_imagePath, _channels, _flip, _texture))
+            return true;
+
+        _texture.file.Close();
+
+        if (!DecodeTexture(_imagePath, _channels, _flip, _texture))
+            return false;
+
+        if (_useCache)
+            SaveTextureCache(_imagePath, _channels, _flip, _texture);
+
+        return true;
+    }
+
+    void DownsampleLevel(const uint8_t *_source, int _width, int _height, int _channels, uint8_t *_destination)
+    {
+        int width = std::max(1, _width / 2);
+        int height = std::max(1, _height / 2);
+        size_t sourceRow = (size_t)_width * _channels;
+
+        // a one texel wide level reads its only column twice
+        int step = (_width > 1) ? _channels : 0;
+
+        for (int y = 0; y < height; y++)
+        {
+            const uint8_t *top = _source + (size_t)(2 * y) * sourceRow;
+            const uint8_t *bottom = (_height > 1) ? top + sourceRow : top;
+            uint8_t *row = _destination + (size_t)y * width * _channels;
+
+            // plain loops over bytes so the compiler can vectorize them
+            for (int x = 0; x < width; x++)
+            {
+                const uint8_t *a = top + (size_t)x * 2 * _channels;
+                const uint8_t *b = bottom + (size_t)x * 2 * _channels;
+
+                for (int c = 0; c < _channels; c++)
+                    row[x * _channels + c] = (uint8_t)((a[c] + a[c + step] + b[c] + b[c + step] + 2) >> 2);
+            }
+        }
+    }
+} // end of Canis namespace
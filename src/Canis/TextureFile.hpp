@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AssetPack.hpp"
+
+namespace Canis
+{
+    // bump when the layout of the file or the mip filter changes, older files are rebuilt
+    const uint32_t TEXTURE_FILE_VERSION = 1;
+    // enough levels for a 32768 texel wide image
+    const int MAX_TEXTURE_LEVELS = 16;
+
+    // start of a .ctex file, level i is (width >> i) x (height >> i) texels, at least 1, at levelOffsets[i]
+    struct TextureFileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t sourceSize; // size and write time of the image the file was built from
+        int64_t sourceTime;
+        uint32_t requestedChannels; // what the loader asked for, 0 keeps the channels of the image
+        uint32_t flipped;
+        uint32_t width;
+        uint32_t height;
+        uint32_t channels;
+        uint32_t levelCount;
+        uint64_t levelOffsets[MAX_TEXTURE_LEVELS];
+    };
+
+    struct TextureLevel
+    {
+        const uint8_t *pixels = nullptr;
+        int width = 0;
+        int height = 0;
+    };
+
+    // an image and its full mip chain ready for glTexImage2D, the levels point into the mapped .ctex, the mounted pack or parsedPixels
+    struct TextureData
+    {
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        int levelCount = 0;
+        TextureLevel levels[MAX_TEXTURE_LEVELS] = {};
+        bool fromCache = false;
+
+        VirtualFile file;
+        std::vector<uint8_t> parsedPixels = {};
+    };
+
+    // the cooked copy of an image is stored next to it
+    extern std::string GetTextureCachePath(const std::string &_imagePath);
+
+    // maps the .ctex when it was built from the image as it is now with the same channels and flip
+    // otherwise decodes the image, builds the mip chain on the cpu and writes a new .ctex
+    // with _useCache false the image is always decoded and no file is written, safe to call from worker threads
+    extern bool LoadTextureData(const std::string &_imagePath, int _channels, bool _flip, TextureData &_texture, bool _useCache = true);
+
+    // 2x2 box filter into a (_width / 2) x (_height / 2) level, a side of 1 texel stays 1 and averages with itself
+    extern void DownsampleLevel(const uint8_t *_source, int _width, int _height, int _channels, uint8_t *_destination);
+} // end of Canis namespace
@@ -0,0 +1,69 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace Canis
+{
+    ThreadPool::ThreadPool(unsigned int _threads)
+    {
+        if (_threads == 0)
+            _threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+        for (unsigned int i = 0; i < _threads; i++)
+            m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_condition.notify_all();
+
+        // jobs still queued are run before the workers exit
+        for (std::thread &worker : m_workers)
+            worker.join();
+    }
+
+    std::future<void> ThreadPool::Submit(std::function<void()> _job)
+    {
+        std::packaged_task<void()> task(std::move(_job));
+        std::future<void> future = task.get_future();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push(std::move(task));
+        }
+        m_condition.notify_one();
+
+        return future;
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while (true)
+        {
+            std::packaged_task<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+
+                if (m_jobs.empty())
+                    return;
+
+                task = std::move(m_jobs.front());
+                m_jobs.pop();
+            }
+
+            task();
+        }
+    }
+
+    ThreadPool &GetThreadPool()
+    {
+        static ThreadPool threadPool;
+        return threadPool;
+    }
+} // end of Canis namespace
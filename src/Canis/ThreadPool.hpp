@@ -0,0 +1,40 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Canis
+{
+    // fixed set of worker threads running submitted jobs in submission order
+    class ThreadPool
+    {
+    public:
+        // 0 uses one thread per core minus the main thread, at least one
+        explicit ThreadPool(unsigned int _threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // the future becomes ready once the job has run, it rethrows anything the job threw
+        std::future<void> Submit(std::function<void()> _job);
+
+        unsigned int GetThreadCount() const { return m_workers.size(); }
+
+    private:
+        void WorkerLoop();
+
+        std::vector<std::thread> m_workers = {};
+        std::queue<std::packaged_task<void()>> m_jobs = {};
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        bool m_stopping = false;
+    };
+
+    // shared pool for loading and generation work, created on first use
+    extern ThreadPool &GetThreadPool();
+} // end of Canis namespace
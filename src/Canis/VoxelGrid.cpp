@@ -0,0 +1,139 @@
+#include "VoxelGrid.hpp"
+#include "AssetPack.hpp"
+#include "Debug.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
+namespace Canis
+{
+    void VoxelGrid::Resize(int _sizeX, int _sizeY, int _sizeZ)
+    {
+        m_sizeX = _sizeX;
+        m_sizeY = _sizeY;
+        m_sizeZ = _sizeZ;
+        m_chunksX = (_sizeX + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        m_chunksY = (_sizeY + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        m_chunksZ = (_sizeZ + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+        m_blocks.assign((size_t)m_chunksX * m_chunksY * m_chunksZ * CHUNK_VOLUME, 0);
+    }
+
+    void VoxelGrid::GetNeighbors(int _x, int _y, int _z, uint8_t _neighbors[6]) const
+    {
+        _neighbors[0] = Get(_x + 1, _y, _z);
+        _neighbors[1] = Get(_x - 1, _y, _z);
+        _neighbors[2] = Get(_x, _y + 1, _z);
+        _neighbors[3] = Get(_x, _y - 1, _z);
+        _neighbors[4] = Get(_x, _y, _z + 1);
+        _neighbors[5] = Get(_x, _y, _z - 1);
+    }
+
+    void VoxelGrid::CopyPaddedChunk(glm::ivec3 _chunk, uint8_t *_paddedBlocks) const
+    {
+        glm::ivec3 origin = _chunk * CHUNK_SIZE;
+        const uint8_t *chunk = GetChunkData(_chunk);
+
+        for (int y = -1; y <= CHUNK_SIZE; y++)
+        {
+            for (int x = -1; x <= CHUNK_SIZE; x++)
+            {
+                bool border = y < 0 || x < 0 || y == CHUNK_SIZE || x == CHUNK_SIZE;
+
+                if (border)
+                {
+                    for (int z = -1; z <= CHUNK_SIZE; z++)
+                        _paddedBlocks[PaddedChunkIndex(x, y, z)] = Get(origin.x + x, origin.y + y, origin.z + z);
+                    continue;
+                }
+
+                // rows along z are contiguous in both layouts
+                memcpy(&_paddedBlocks[PaddedChunkIndex(x, y, 0)], &chunk[(y * CHUNK_SIZE + x) * CHUNK_SIZE], CHUNK_SIZE);
+                _paddedBlocks[PaddedChunkIndex(x, y, -1)] = Get(origin.x + x, origin.y + y, origin.z - 1);
+                _paddedBlocks[PaddedChunkIndex(x, y, CHUNK_SIZE)] = Get(origin.x + x, origin.y + y, origin.z + CHUNK_SIZE);
+            }
+        }
+    }
+
+    namespace
+    {
+        // next whitespace separated number, false at the end or at anything that is not a number like ifstream's >>
+        bool ReadNumber(const char *&_cursor, const char *_end, int &_number)
+        {
+            while (_cursor < _end && isspace((unsigned char)*_cursor))
+                _cursor++;
+
+            std::from_chars_result result = std::from_chars(_cursor, _end, _number);
+            if (result.ec != std::errc())
+                return false;
+
+            _cursor = result.ptr;
+            return true;
+        }
+    }
+
+    bool LoadMap(std::string _path, VoxelGrid &_grid)
+    {
+        VirtualFile file;
+        if (!file.Open(_path))
+        {
+            Error("Map not found at: " + _path);
+            return false;
+        }
+
+        // the rows can have different lengths so read everything before sizing the grid
+        struct Cell
+        {
+            int x, y, z;
+            int block;
+        };
+
+        std::vector<Cell> cells;
+        int number = 0;
+        int x = 0, y = 0, z = 0;
+        int sizeX = 1, sizeY = 1, sizeZ = 0;
+        const char *cursor = file.GetData();
+        const char *end = cursor + file.GetSize();
+
+        while (ReadNumber(cursor, end, number))
+        {
+            if (number == -2) // add new layer
+            {
+                y++;
+                x = 0;
+                z = 0;
+                sizeY = y + 1;
+                continue;
+            }
+
+            if (number == -1) // add new row
+            {
+                x++;
+                z = 0;
+                sizeX = std::max(sizeX, x + 1);
+                continue;
+            }
+
+            if (number < 0 || number > 255)
+            {
+                Warning("Block id " + std::to_string(number) + " in " + _path + " does not fit in a byte and was replaced with air");
+                number = 0;
+            }
+
+            if (number != 0)
+                cells.push_back({x, y, z, number});
+
+            z++;
+            sizeZ = std::max(sizeZ, z);
+        }
+
+        _grid.Resize(sizeX, sizeY, sizeZ);
+
+        for (const Cell &cell : cells)
+            _grid.Set(cell.x, cell.y, cell.z, (uint8_t)cell.block);
+
+        return true;
+    }
+} // end of Canis namespace
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "ChunkMesher.hpp"
+
+namespace Canis
+{
+    // dense block ids in one allocation, stored chunk by chunk so a CHUNK_SIZE^3 chunk is contiguous
+    // inside a chunk blocks are ordered y, x, z like PaddedChunkIndex
+    class VoxelGrid
+    {
+    public:
+        // sizes are rounded up to whole chunks, every block starts as air
+        void Resize(int _sizeX, int _sizeY, int _sizeZ);
+        void Clear() { Resize(0, 0, 0); }
+
+        int GetSizeX() const { return m_sizeX; }
+        int GetSizeY() const { return m_sizeY; }
+        int GetSizeZ() const { return m_sizeZ; }
+        glm::ivec3 GetChunkCount() const { return glm::ivec3(m_chunksX, m_chunksY, m_chunksZ); }
+
+        bool InBounds(int _x, int _y, int _z) const
+        {
+            return _x >= 0 && _y >= 0 && _z >= 0 && _x < m_sizeX && _y < m_sizeY && _z < m_sizeZ;
+        }
+
+        // returns 0 (air) outside of the grid
+        uint8_t Get(int _x, int _y, int _z) const
+        {
+            return InBounds(_x, _y, _z) ? m_blocks[Index(_x, _y, _z)] : 0;
+        }
+
+        // ignored outside of the grid
+        void Set(int _x, int _y, int _z, uint8_t _block)
+        {
+            if (InBounds(_x, _y, _z))
+                m_blocks[Index(_x, _y, _z)] = _block;
+        }
+
+        // fills _neighbors with the blocks at +x, -x, +y, -y, +z and -z
+        void GetNeighbors(int _x, int _y, int _z, uint8_t _neighbors[6]) const;
+
+        // copies chunk _chunk plus a one block border into a CHUNK_PADDED_VOLUME buffer for BuildChunkMesh
+        void CopyPaddedChunk(glm::ivec3 _chunk, uint8_t *_paddedBlocks) const;
+
+        const uint8_t *GetChunkData(glm::ivec3 _chunk) const { return &m_blocks[ChunkIndex(_chunk.x, _chunk.y, _chunk.z) * CHUNK_VOLUME]; }
+        uint8_t *GetChunkData(glm::ivec3 _chunk) { return &m_blocks[ChunkIndex(_chunk.x, _chunk.y, _chunk.z) * CHUNK_VOLUME]; }
+        size_t GetMemoryUsage() const { return m_blocks.size() * sizeof(uint8_t); }
+
+        static const int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+    private:
+        static const int CHUNK_SHIFT = 4;
+        static const int CHUNK_MASK = CHUNK_SIZE - 1;
+        static_assert(CHUNK_SIZE == (1 << CHUNK_SHIFT), "chunk indexing uses shifts");
+
+        size_t ChunkIndex(int _cx, int _cy, int _cz) const
+        {
+            return ((size_t)_cy * m_chunksX + _cx) * m_chunksZ + _cz;
+        }
+
+        size_t Index(int _x, int _y, int _z) const
+        {
+            size_t chunk = ChunkIndex(_x >> CHUNK_SHIFT, _y >> CHUNK_SHIFT, _z >> CHUNK_SHIFT);
+            size_t local = (((_y & CHUNK_MASK) << CHUNK_SHIFT | (_x & CHUNK_MASK)) << CHUNK_SHIFT) | (_z & CHUNK_MASK);
+            return chunk * CHUNK_VOLUME + local;
+        }
+
+        std::vector<uint8_t> m_blocks = {};
+        int m_sizeX = 0;
+        int m_sizeY = 0;
+        int m_sizeZ = 0;
+        int m_chunksX = 0;
+        int m_chunksY = 0;
+        int m_chunksZ = 0;
+    };
+
+    // loads a text .map where -1 starts a new row (x) and -2 a new layer (y), each number is a block along z
+    // ragged rows are padded with air, MapFile.hpp has the binary .cmap that loads much faster
+    extern bool LoadMap(std::string _path, VoxelGrid &_grid);
+} // end of Canis namespace
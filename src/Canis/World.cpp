@@ -1,10 +1,14 @@
 #include "World.hpp"
 #include "IOManager.hpp"
+#include "Debug.hpp"
+#include "Data/UniformBlocks.hpp"
 
 #include <SDL.h>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cstddef>
+#include <algorithm>
 
 using namespace glm;
 
@@ -16,12 +20,13 @@ namespace Canis
         m_inputManager = _inputManager;
         m_totalTime = 0.0; // Initialize time at construction
 
-        m_skyboxShader.Compile("assets/shaders/skybox.vs", "assets/shaders/skybox.fs");
-        m_skyboxShader.AddAttribute("aPosition");
-        m_skyboxShader.Link();
-        m_skyboxShader.Use();
-        m_skyboxShader.SetInt("SKYBOX", 0);
-        m_skyboxShader.UnUse();
+        AssetManager &assets = GetAssetManager();
+
+        m_skyboxShader = assets.LoadShader("assets/shaders/skybox.vs", "assets/shaders/skybox.fs", {"aPosition"});
+        Shader &skyboxShader = assets.Get(m_skyboxShader);
+        skyboxShader.Use();
+        skyboxShader.SetInt("SKYBOX", 0);
+        skyboxShader.UnUse();
 
         /// Load Skybox
         std::vector<std::string> faces;
@@ -35,8 +40,35 @@ namespace Canis
 
         m_skyboxId = Canis::LoadImageToCubemap(faces, GL_RGBA);
 
-        m_skyboxModel = LoadModel("assets/models/cube.obj");
+        // shared with anything else drawing cube.obj
+        m_skyboxModel = assets.LoadModel("assets/models/cube.obj");
         /// End of Skybox
+
+        glGenBuffers(1, &m_instanceVBO);
+
+        // per frame data shared by every shader, see Data/UniformBlocks.hpp
+        glGenBuffers(1, &m_frameUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameBlock), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, m_frameUBO);
+
+        glGenBuffers(1, &m_lightUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_lightUBO);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBlock), nullptr, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BLOCK_BINDING, m_lightUBO);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    World::~World()
+    {
+        // the cubemap is loaded outside the asset manager so it is only ever the world's
+        glDeleteTextures(1, &m_skyboxId);
+        GetAssetManager().Release(m_skyboxShader);
+        GetAssetManager().Release(m_skyboxModel);
+
+        glDeleteBuffers(1, &m_instanceVBO);
+        glDeleteBuffers(1, &m_frameUBO);
+        glDeleteBuffers(1, &m_lightUBO);
     }
 
     void World::Update(double _deltaTime)
@@ -46,13 +78,23 @@ namespace Canis
         
         UpdateCameraMovement(_deltaTime);
 
-        for (int i = 0; i < m_entities.size(); i++)
+        // despawning reorders the arrays so it waits until every entity has updated
+        m_updating = true;
+
+        std::vector<UpdateFunction> &updates = m_entities.GetUpdates();
+        for (unsigned int i = 0; i < m_entities.Size(); i++)
         {
-            if (m_entities[i].Update != nullptr)
+            if (updates[i] != nullptr)
             {
-                m_entities[i].Update(*this, m_entities[i], 0.1f);
+                updates[i](*this, m_entities.GetHandle(i), 0.1f);
             }
         }
+
+        m_updating = false;
+
+        for (EntityHandle entity : m_pendingDespawns)
+            m_entities.Despawn(entity);
+        m_pendingDespawns.clear();
     }
 
     void World::Draw(double _deltaTime)
@@ -62,56 +104,262 @@ namespace Canis
                               (float)m_window->GetScreenWidth() / (float)m_window->GetScreenHeight(),
                               0.01f, 100.0f);
 
-        for (int i = 0; i < m_entities.size(); i++)
-        {
-            if (m_entities[i].active == false)
-                continue;
-
-            Shader *shader = m_entities[i].shader;
-            shader->Use();
-            shader->SetVec3("COLOR", m_entities[i].color);
-            shader->SetVec3("VIEWPOS", m_camera.Position);
-            shader->SetInt("NUMBEROFPOINTLIGHTS", 4);
-            shader->SetFloat("TIME", m_totalTime); // Use our tracked time instead of SDL_GetTicks
+        mat4 view = m_camera.GetViewMatrix();
 
-            UpdateLights(*shader);
+        m_renderStats = RenderStats();
 
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, m_entities[i].albedo->id);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, m_entities[i].specular->id);
+        // static entities keep their matrix from the frame they were spawned
+        m_renderStats.matricesUpdated = m_entities.UpdateMatrices();
 
-            shader->SetMat4("VIEW", m_camera.GetViewMatrix());
-            shader->SetMat4("PROJECTION", project);
+        UpdateFrameBuffer(view, project);
+        UpdateLightBuffer();
 
-            shader->SetMat4("TRANSFORM", m_entities[i].transform.Matrix());
-            Canis::Draw(*m_entities[i].model);
-            shader->UnUse();
-        }
+        BuildRenderQueue(Frustum::FromMatrix(project * view));
+        m_renderQueue.Sort();
+        SubmitRenderQueue();
+        ResetRenderState();
 
         // Skybox
+        Shader &skyboxShader = GetAssetManager().Get(m_skyboxShader);
+
         glDepthFunc(GL_LEQUAL);
-        m_skyboxShader.Use();
-        // the cast to mat3 removes position of the camera as a factor
-        m_skyboxShader.SetMat4("VIEW", glm::mat4(glm::mat3(m_camera.GetViewMatrix())));
-        m_skyboxShader.SetMat4("PROJECTION", project);
+        skyboxShader.Use();
 
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_CUBE_MAP, m_skyboxId);
-        Canis::Draw(m_skyboxModel);
+        Canis::Draw(GetAssetManager().Get(m_skyboxModel));
 
-        m_skyboxShader.UnUse();
+        skyboxShader.UnUse();
         glDepthFunc(GL_LESS);
+        m_renderStats.drawCalls++;
         // End of Skybox
     }
 
-    void World::Spawn(Entity _entity)
+    Shader *World::GetDrawShader(const RenderData &_renderData)
     {
-        m_entities.push_back(_entity);
+        if (m_instancing && _renderData.shader->GetInstancedVariant() != nullptr)
+            return _renderData.shader->GetInstancedVariant();
+
+        return _renderData.shader;
+    }
+
+    bool World::CanBatch(const RenderData &_a, const RenderData &_b)
+    {
+        return _a.model == _b.model && _a.shader == _b.shader &&
+               _a.albedo == _b.albedo && _a.specular == _b.specular && _a.emission == _b.emission;
+    }
+
+    void World::BuildRenderQueue(const Frustum &_frustum)
+    {
+        m_renderQueue.Clear();
+
+        std::vector<uint8_t> &active = m_entities.GetActive();
+        std::vector<Transform> &transforms = m_entities.GetTransforms();
+        std::vector<RenderData> &renderData = m_entities.GetRenderData();
+
+        for (unsigned int i = 0; i < m_entities.Size(); i++)
+        {
+            if (active[i] == false)
+                continue;
+
+            const RenderData &entity = renderData[i];
+
+            if (m_frustumCulling)
+            {
+                Model &model = *entity.model;
+
+                if (!_frustum.IntersectsAABB(transforms[i].Matrix(), model.boundsMin, model.boundsMax))
+                {
+                    m_renderStats.culledEntities++;
+                    continue;
+                }
+            }
+
+            m_renderStats.visibleEntities++;
+
+            float depth = distance(transforms[i].position, m_camera.Position) / m_camera.farPlane;
+
+            // blended entities are sorted by their middle, a chunk's position is its corner
+            if (entity.transparent)
+            {
+                vec3 center = vec3(transforms[i].Matrix() * vec4((entity.model->boundsMin + entity.model->boundsMax) * 0.5f, 1.0f));
+                depth = distance(center, m_camera.Position) / m_camera.farPlane;
+            }
+
+            uint64_t key = m_renderQueue.MakeKey(entity.transparent ? TRANSPARENT_PASS : OPAQUE_PASS, GetDrawShader(entity)->GetProgramID(),
+                                                 entity.albedo->id, entity.specular->id,
+                                                 (entity.emission != nullptr) ? entity.emission->id : 0,
+                                                 entity.model->VAO, depth);
+            m_renderQueue.Push(key, i);
+        }
+    }
+
+    void World::SubmitRenderQueue()
+    {
+        const std::vector<RenderCommand> &commands = m_renderQueue.GetCommands();
+        std::vector<Transform> &transforms = m_entities.GetTransforms();
+        std::vector<RenderData> &renderData = m_entities.GetRenderData();
+
+        // sorting keeps entities that share state next to each other so they can be merged into runs
+        m_drawRuns.clear();
+        m_instanceData.clear();
+
+        size_t index = 0;
+        while (index < commands.size())
+        {
+            const RenderData &entity = renderData[commands[index].entity];
+
+            DrawRun run;
+            run.firstCommand = index;
+            run.count = 1;
+            run.instanced = (GetDrawShader(entity) != entity.shader);
+
+            if (run.instanced)
+            {
+                while (index + run.count < commands.size() &&
+                       CanBatch(entity, renderData[commands[index + run.count].entity]))
+                    run.count++;
+
+                run.firstInstance = m_instanceData.size();
+
+                for (size_t i = index; i < index + run.count; i++)
+                {
+                    unsigned int instance = commands[i].entity;
+                    m_instanceData.push_back({transforms[instance].Matrix(), renderData[instance].color});
+                }
+            }
+
+            m_drawRuns.push_back(run);
+            index += run.count;
+        }
+
+        // one upload for every batch this frame
+        if (!m_instanceData.empty())
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(InstanceData) * m_instanceData.size(), m_instanceData.data(), GL_STREAM_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        for (DrawRun &run : m_drawRuns)
+        {
+            unsigned int first = commands[run.firstCommand].entity;
+            const RenderData &entity = renderData[first];
+            Shader *shader = GetDrawShader(entity);
+
+            BindProgram(*shader);
+            BindTexture(0, *entity.albedo);
+            BindTexture(1, *entity.specular);
+
+            // block_flat uses a third texture for the bottom face
+            if (entity.emission != nullptr)
+                BindTexture(2, *entity.emission);
+            BindVAO(entity.model->VAO);
+
+            if (run.instanced == false)
+            {
+                shader->SetVec3(UniformId("COLOR"), entity.color);
+                shader->SetMat4(UniformId("TRANSFORM"), transforms[first].Matrix());
+                DrawBound(*entity.model);
+
+                m_renderStats.drawCalls++;
+                m_renderStats.entitiesDrawn++;
+                continue;
+            }
+
+            glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+
+            // TRANSFORM takes locations 3 - 6 and COLOR takes 7
+            size_t offset = run.firstInstance * sizeof(InstanceData);
+
+            for (int column = 0; column < 4; column++)
+            {
+                glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                                      (void *)(offset + offsetof(InstanceData, transform) + sizeof(vec4) * column));
+                glEnableVertexAttribArray(3 + column);
+                glVertexAttribDivisor(3 + column, 1);
+            }
+
+            glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (void *)(offset + offsetof(InstanceData, color)));
+            glEnableVertexAttribArray(7);
+            glVertexAttribDivisor(7, 1);
+
+            DrawBound(*entity.model, run.count);
+
+            // the vao is shared with the non instanced path
+            for (int location = 3; location <= 7; location++)
+                glDisableVertexAttribArray(location);
+
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            m_renderStats.drawCalls++;
+            m_renderStats.instancedBatches++;
+            m_renderStats.entitiesDrawn += run.count;
+        }
+    }
+
+    void World::BindProgram(Shader &_shader)
+    {
+        if (m_boundProgram == (unsigned int)_shader.GetProgramID())
+            return;
+
+        _shader.Use();
+        m_boundProgram = _shader.GetProgramID();
+        m_renderStats.programSwitches++;
+    }
+
+    void World::BindTexture(int _unit, const GLTexture &_texture)
+    {
+        if (m_boundTextures[_unit] == _texture.id)
+            return;
+
+        glActiveTexture(GL_TEXTURE0 + _unit);
+        glBindTexture((_texture.layers > 0) ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, _texture.id);
+        m_boundTextures[_unit] = _texture.id;
+        m_renderStats.textureBinds++;
+    }
+
+    void World::BindVAO(unsigned int _vao)
+    {
+        if (m_boundVAO == _vao)
+            return;
+
+        glBindVertexArray(_vao);
+        m_boundVAO = _vao;
+        m_renderStats.vaoBinds++;
+    }
+
+    void World::ResetRenderState()
+    {
+        glBindVertexArray(0);
+        glUseProgram(0);
+        m_boundProgram = 0;
+        m_boundVAO = 0;
+
+        // textures stay bound but other code (skybox, editor) may rebind the units
+        m_boundTextures[0] = 0;
+        m_boundTextures[1] = 0;
+        m_boundTextures[2] = 0;
+    }
+
+    EntityHandle World::Spawn(Entity _entity)
+    {
+        return m_entities.Spawn(_entity);
+    }
+
+    void World::Despawn(EntityHandle _entity)
+    {
+        if (m_updating)
+            m_pendingDespawns.push_back(_entity);
+        else
+            m_entities.Despawn(_entity);
     }
 
     void World::SpawnPointLight(PointLight _light)
     {
+        if (m_pointLights.size() == MAX_POINT_LIGHTS)
+            Warning("Only the first " + std::to_string(MAX_POINT_LIGHTS) + " point lights are sent to the shaders");
+
         m_pointLights.push_back(_light);
     }
 
@@ -120,28 +368,31 @@ namespace Canis
         m_directionalLight = _light;
     }
 
-    Entity *World::GetEntityWithTag(std::string _tag)
+    EntityHandle World::GetEntityWithTag(std::string _tag)
     {
-        for (int i = 0; i < m_entities.size(); i++)
+        std::vector<std::string> &tags = m_entities.GetTags();
+
+        for (unsigned int i = 0; i < m_entities.Size(); i++)
         {
-            if (m_entities[i].tag == _tag)
+            if (tags[i] == _tag)
             {
-                return &m_entities[i];
+                return m_entities.GetHandle(i);
             }
         }
 
-        return nullptr;
+        return EntityHandle();
     }
 
-    std::vector<Entity *> World::GetEntitiesWithTag(std::string _tag)
+    std::vector<EntityHandle> World::GetEntitiesWithTag(std::string _tag)
     {
-        std::vector<Entity *> matches = {};
+        std::vector<EntityHandle> matches = {};
+        std::vector<std::string> &tags = m_entities.GetTags();
 
-        for (int i = 0; i < m_entities.size(); i++)
+        for (unsigned int i = 0; i < m_entities.Size(); i++)
         {
-            if (m_entities[i].tag == _tag)
+            if (tags[i] == _tag)
             {
-                matches.push_back(&m_entities[i]);
+                matches.push_back(m_entities.GetHandle(i));
             }
         }
 
@@ -158,23 +409,44 @@ namespace Canis
         return nullptr;
     }
 
-    void World::UpdateLights(Canis::Shader &_shader)
+    void World::UpdateFrameBuffer(const mat4 &_view, const mat4 &_projection)
     {
-        _shader.SetVec3("DIRECTIONALLIGHT.direction", m_directionalLight.direction);
-        _shader.SetVec3("DIRECTIONALLIGHT.ambient", m_directionalLight.ambient);
-        _shader.SetVec3("DIRECTIONALLIGHT.diffuse", m_directionalLight.diffuse);
-        _shader.SetVec3("DIRECTIONALLIGHT.specular", m_directionalLight.specular);
+        FrameBlock frame;
+        frame.view = _view;
+        frame.projection = _projection;
+        frame.viewPosition = m_camera.Position;
+        frame.time = m_totalTime; // Use our tracked time instead of SDL_GetTicks
+
+        glBindBuffer(GL_UNIFORM_BUFFER, m_frameUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameBlock), &frame);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
 
-        for (int i = 0; i < m_pointLights.size(); i++)
+    void World::UpdateLightBuffer()
+    {
+        LightBlock lights = {};
+        lights.directionalLight.direction = vec4(m_directionalLight.direction, 0.0f);
+        lights.directionalLight.ambient = vec4(m_directionalLight.ambient, 0.0f);
+        lights.directionalLight.diffuse = vec4(m_directionalLight.diffuse, 0.0f);
+        lights.directionalLight.specular = vec4(m_directionalLight.specular, 0.0f);
+
+        lights.numberOfPointLights = std::min((int)m_pointLights.size(), MAX_POINT_LIGHTS);
+
+        for (int i = 0; i < lights.numberOfPointLights; i++)
         {
-            _shader.SetVec3("POINTLIGHTS[" + std::to_string(i) + "].position", m_pointLights[i].position);
-            _shader.SetVec3("POINTLIGHTS[" + std::to_string(i) + "].ambient", m_pointLights[i].ambient);
-            _shader.SetVec3("POINTLIGHTS[" + std::to_string(i) + "].diffuse", m_pointLights[i].diffuse);
-            _shader.SetVec3("POINTLIGHTS[" + std::to_string(i) + "].specular", m_pointLights[i].specular);
-            _shader.SetFloat("POINTLIGHTS[" + std::to_string(i) + "].constant", m_pointLights[i].constant);
-            _shader.SetFloat("POINTLIGHTS[" + std::to_string(i) + "].linear", m_pointLights[i].linear);
-            _shader.SetFloat("POINTLIGHTS[" + std::to_string(i) + "].quadratic", m_pointLights[i].quadratic);
+            PointLightStd140 &light = lights.pointLights[i];
+            light.position = vec4(m_pointLights[i].position, 0.0f);
+            light.ambient = vec4(m_pointLights[i].ambient, 0.0f);
+            light.diffuse = vec4(m_pointLights[i].diffuse, 0.0f);
+            light.specular = m_pointLights[i].specular;
+            light.constant = m_pointLights[i].constant;
+            light.linear = m_pointLights[i].linear;
+            light.quadratic = m_pointLights[i].quadratic;
         }
+
+        glBindBuffer(GL_UNIFORM_BUFFER, m_lightUBO);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightBlock), &lights);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
     }
 
     void World::UpdateCameraMovement(double _deltaTime)
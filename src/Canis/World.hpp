@@ -2,6 +2,10 @@
 #include <vector>
 #include "Camera.hpp"
 #include "Entity.hpp"
+#include "EntityStorage.hpp"
+#include "RenderQueue.hpp"
+#include "AssetManager.hpp"
+#include "Frustum.hpp"
 #include "Window.hpp"
 #include "InputManager.hpp"
 #include "Data/PointLight.hpp"
@@ -9,38 +13,110 @@
 
 namespace Canis
 {
+    struct RenderStats
+    {
+        unsigned int drawCalls = 0;
+        unsigned int instancedBatches = 0;
+        unsigned int entitiesDrawn = 0;
+        unsigned int programSwitches = 0;
+        unsigned int textureBinds = 0;
+        unsigned int vaoBinds = 0;
+        unsigned int visibleEntities = 0;
+        unsigned int culledEntities = 0;
+        unsigned int matricesUpdated = 0;
+    };
+
     class World
     {
     public:
         World(Window *_window, InputManager *_inputManager, std::string _skyboxPath);
+        ~World();
+
+        World(const World &) = delete;
+        World &operator=(const World &) = delete;
+
         void Update(double _deltaTime);
         void Draw(double _deltaTime);
-        void Spawn(Entity _entity);
+        EntityHandle Spawn(Entity _entity);
+        void Despawn(EntityHandle _entity); // deferred until the update loop ends when called from an Update function
         void SpawnPointLight(PointLight _light);
         void SpawnDirectionalLight(DirectionalLight _light);
         Camera& GetCamera() { return m_camera; }
-        Entity* GetEntity(unsigned int _index) { return &m_entities[_index]; }
-        std::vector<Entity>& GetEntities() { return m_entities; }
-        int GetEntitiesSize() { return m_entities.size(); }
-        Entity* GetEntityWithTag(std::string _tag);
-        std::vector<Entity*> GetEntitiesWithTag(std::string _tag);
+        EntityStorage& GetEntities() { return m_entities; }
+        int GetEntitiesSize() { return m_entities.Size(); }
+        bool IsValid(EntityHandle _entity) { return m_entities.IsValid(_entity); }
+        Transform& GetTransform(EntityHandle _entity) { return m_entities.GetTransform(_entity); }
+        RenderData& GetRenderData(EntityHandle _entity) { return m_entities.GetRenderData(_entity); }
+        EntityHandle GetEntityWithTag(std::string _tag); // returns an invalid handle when no entity has the tag
+        std::vector<EntityHandle> GetEntitiesWithTag(std::string _tag);
         PointLight* GetPointLight(glm::vec3 _position); // returns nullptr when light is not found
         DirectionalLight& GetDirectionalLight() { return m_directionalLight; }
         double GetTime() const { return m_totalTime; } // Added GetTime method
 
+        // when enabled entities sharing model, shader and textures are drawn with one instanced draw call
+        void SetInstancing(bool _instancing) { m_instancing = _instancing; }
+        bool GetInstancing() { return m_instancing; }
+        const RenderStats& GetRenderStats() { return m_renderStats; }
+
+        // skips entities whose bounds are outside the camera before any gl work
+        void SetFrustumCulling(bool _frustumCulling) { m_frustumCulling = _frustumCulling; }
+        bool GetFrustumCulling() { return m_frustumCulling; }
+
     private:
         InputManager *m_inputManager;
         Window *m_window;
         Camera m_camera = Camera(glm::vec3(0.0f, 0.0f, -3.0f));
-        Shader m_skyboxShader;
+        ShaderHandle m_skyboxShader;
         unsigned int m_skyboxId;
-        Model m_skyboxModel;
+        ModelHandle m_skyboxModel;
         DirectionalLight m_directionalLight;
-        std::vector<Entity> m_entities = {};
+        EntityStorage m_entities;
+        bool m_updating = false;
+        std::vector<EntityHandle> m_pendingDespawns = {};
         std::vector<PointLight> m_pointLights = {};
         double m_totalTime = 0.0; // Added time tracking
 
-        void UpdateLights(Canis::Shader &_shader);
+        struct InstanceData
+        {
+            glm::mat4 transform;
+            glm::vec3 color;
+        };
+
+        // a run of sorted commands that is drawn with one draw call
+        struct DrawRun
+        {
+            size_t firstCommand = 0;
+            size_t count = 0;
+            size_t firstInstance = 0;
+            bool instanced = false;
+        };
+
+        bool m_instancing = true;
+        bool m_frustumCulling = true;
+        unsigned int m_instanceVBO = 0;
+        std::vector<InstanceData> m_instanceData = {};
+        RenderQueue m_renderQueue;
+        unsigned int m_frameUBO = 0;
+        unsigned int m_lightUBO = 0;
+        std::vector<DrawRun> m_drawRuns = {};
+
+        // gl state the queue submission has bound so far this frame
+        unsigned int m_boundProgram = 0;
+        unsigned int m_boundTextures[3] = {};
+        unsigned int m_boundVAO = 0;
+
+        RenderStats m_renderStats;
+
+        Shader* GetDrawShader(const RenderData &_renderData);
+        bool CanBatch(const RenderData &_a, const RenderData &_b);
+        void BuildRenderQueue(const Frustum &_frustum);
+        void SubmitRenderQueue();
+        void BindProgram(Shader &_shader);
+        void BindTexture(int _unit, const GLTexture &_texture);
+        void BindVAO(unsigned int _vao);
+        void ResetRenderState();
+        void UpdateFrameBuffer(const glm::mat4 &_view, const glm::mat4 &_projection);
+        void UpdateLightBuffer();
         void UpdateCameraMovement(double _deltaTime);
     };
 }
\ No newline at end of file
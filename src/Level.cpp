@@ -0,0 +1,133 @@
+#include "Level.hpp"
+#include "Canis/Debug.hpp"
+#include "Canis/MeshFile.hpp"
+#include "Canis/TextureFile.hpp"
+#include "Canis/MapFile.hpp"
+#include "Canis/TerrainGenerator.hpp"
+
+// block ids of the level, indexed (x, y, z) where y is the map layer
+Canis::VoxelGrid map;
+
+// declaring functions
+void RandomizeGrassAndFlowers(int startY, int endY, int startX, int endX, float grassChance, float flowerChance);
+void SetupRandomVegetation();
+
+std::vector<Canis::TextureRequest> GetLevelTextures()
+{
+    return {
+        {"assets/textures/grass.png", false},
+        {"assets/textures/blue_orchid.png", false},
+        {"assets/textures/container2_specular.png", true},
+    };
+}
+
+std::vector<std::string> GetFirePaths()
+{
+    std::vector<std::string> firePaths;
+    for (int i = 1; i <= FIRE_FRAME_COUNT; i++)
+        firePaths.push_back("assets/textures/fire_textures/fire_" + std::to_string(i) + ".png");
+    return firePaths;
+}
+
+// every image the level loads, the blocks have to be registered
+std::vector<std::string> GetLevelImagePaths(const Canis::BlockRegistry &_blocks)
+{
+    std::vector<std::string> paths;
+    for (const Canis::TextureRequest &request : GetLevelTextures())
+        paths.push_back(request.path);
+
+    paths.insert(paths.end(), _blocks.GetLayerPaths().begin(), _blocks.GetLayerPaths().end());
+
+    std::vector<std::string> firePaths = GetFirePaths();
+    paths.insert(paths.end(), firePaths.begin(), firePaths.end());
+    return paths;
+}
+
+// cpu side of every image and model of the level, writes the .ctex and .cmesh files that are missing
+void PrepareLevelAssets(const std::vector<std::string> &_imagePaths, bool _textureCache, bool _meshCache)
+{
+    for (const std::string &path : _imagePaths)
+    {
+        Canis::TextureData texture;
+        Canis::LoadTextureData(path, 4, true, texture, _textureCache);
+    }
+
+    const char *models[2] = {"assets/models/plants.obj", "assets/models/fire.obj"};
+    for (const char *path : models)
+    {
+        Canis::MeshData mesh;
+        Canis::LoadMeshData(path, mesh, _meshCache);
+    }
+}
+
+bool LoadLevelMap()
+{
+    // the .cmap is made from the text map on the first run and again whenever the text map changes
+    const std::string textPath = "assets/maps/level.map";
+    const std::string binaryPath = "assets/maps/level.cmap";
+
+    if (Canis::IsMapFileCurrent(binaryPath, textPath))
+    {
+        if (!Canis::LoadMapFile(binaryPath, map))
+            return false;
+    }
+    else
+    {
+        Canis::Log(binaryPath + " is missing or older than " + textPath + ", converting it");
+        if (!Canis::LoadMap(textPath, map))
+            return false;
+
+        // the level still loads when the .cmap can not be written
+        Canis::SaveMapFile(binaryPath, map, textPath);
+    }
+
+    // Add this line to randomize grass and flowers in the specified region
+    SetupRandomVegetation();
+    return true;
+}
+
+// Function to randomly place flowers and grass in a specific area of the map
+// every cell draws its own number from the world seed, so override_seed in project.canis repeats the layout
+void RandomizeGrassAndFlowers(int startY, int endY, int startX, int endX, float grassChance = 0.4f, float flowerChance = 0.3f)
+{
+    // Verify the map is properly loaded
+    if (map.GetSizeY() < 2 || map.GetSizeX() < endY || map.GetSizeZ() < endX) {
+        Canis::Error("Map is not properly loaded or the vegetation region is out of bounds");
+        return;
+    }
+
+    const uint32_t VEGETATION_STREAM = 100;
+    uint64_t seed = Canis::GetWorldSeed();
+
+    // For each position in the specified region (second level = index 1)
+    for (int y = startY; y < endY; y++) {
+        for (int x = startX; x < endX; x++) {
+            float randomValue = Canis::RandomFloat(seed, y, 1, x, VEGETATION_STREAM);
+
+            if (randomValue < grassChance)
+                map.Set(y, 1, x, 2); // Place grass (2)
+            else if (randomValue < (grassChance + flowerChance))
+                map.Set(y, 1, x, 6); // Place flower (6)
+            else
+                map.Set(y, 1, x, 0); // Leave empty (0) - this gives a chance for some spots to remain empty
+        }
+    }
+}
+
+// This function should be called after LoadMap and before entity spawning
+void SetupRandomVegetation()
+{
+    // Randomize grass and flowers in the 5x5 section on level 1 (index 1 in map array)
+    // Parameters: startY, endY, startX, endX, grassChance, flowerChance
+    RandomizeGrassAndFlowers(5, 10, 15, 20, 0.4f, 0.3f);
+}
+
+// the cube block ids of the maps, everything else is spawned as an entity
+void SetupBlocks(Canis::BlockRegistry &_blocks)
+{
+    _blocks.Register(1, "glass", true, "assets/textures/glass.png"); // glass lets you see the faces behind it
+    _blocks.Register(3, "oakplank", false, "assets/textures/oak_planks.png");
+    _blocks.Register(4, "dirt", false, "assets/textures/grass_block_side.png", "assets/textures/grass_block_top.png", "assets/textures/dirt_bottom.png");
+    _blocks.Register(5, "brick", false, "assets/textures/bricks.png");
+    _blocks.Register(8, "house", false, "assets/textures/house.png");
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Canis/VoxelGrid.hpp"
+#include "Canis/BlockRegistry.hpp"
+#include "Canis/IOManager.hpp"
+
+// the demo level, shared by main.cpp and the benchmarks that load it without a window
+
+const int FIRE_FRAME_COUNT = 31;  // Number of fire frames (1-31)
+
+// block ids of the level, indexed (x, y, z) where y is the map layer
+extern Canis::VoxelGrid map;
+
+void SetupBlocks(Canis::BlockRegistry &_blocks);
+std::vector<Canis::TextureRequest> GetLevelTextures();
+std::vector<std::string> GetFirePaths();
+std::vector<std::string> GetLevelImagePaths(const Canis::BlockRegistry &_blocks);
+void PrepareLevelAssets(const std::vector<std::string> &_imagePaths, bool _textureCache, bool _meshCache);
+// loads the .cmap into map, converting the text map when the .cmap is missing or stale, then places the vegetation
+bool LoadLevelMap();
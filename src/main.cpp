@@ -1,4 +1,5 @@
 #ifdef _WIN32
+#define NOMINMAX
 #include <windows.h>
 #endif
 
@@ -7,7 +8,11 @@
 #include <fstream>
 #include <vector>
 #include <cstdlib>  // for rand() and srand()
-#include <ctime>    // for time()
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+#include <SDL.h>
 #include "Canis/Canis.hpp"
 #include "Canis/Entity.hpp"
 #include "Canis/Graphics.hpp"
@@ -18,9 +23,22 @@
 #include "Canis/InputManager.hpp"
 #include "Canis/Camera.hpp"
 #include "Canis/Model.hpp"
+#include "Canis/ChunkMesher.hpp"
+#include "Canis/BlockRegistry.hpp"
+#include "Canis/AssetManager.hpp"
+#include "Canis/MeshFile.hpp"
+#include "Canis/TextureFile.hpp"
+#include "Canis/AssetPack.hpp"
+#include "Canis/Task.hpp"
+#include "Canis/VoxelGrid.hpp"
+#include "Canis/MapFile.hpp"
+#include "Canis/ChunkStreamer.hpp"
+#include "Canis/TerrainGenerator.hpp"
 #include "Canis/World.hpp"
 #include "Canis/Editor.hpp"
 #include "Canis/FrameRateManager.hpp"
+#include "Level.hpp"
+#include "Benchmarks.hpp"
 
 using namespace glm;
 
@@ -28,20 +46,53 @@ using namespace glm;
 // git fetch
 // git pull
 
-// 3d array
-std::vector<std::vector<std::vector<unsigned int>>> map = {};
+// one model per streamed chunk holding every block type, rebuilt in place when the meshing mode changes
+struct ChunkModel
+{
+    glm::ivec3 chunk;
+    bool meshed = false; // model and entity are only made for a chunk with cube faces
+    Canis::Model model;
+    Canis::EntityHandle entity;
+    std::vector<Canis::EntityHandle> props = {}; // the grass, flowers and fire standing in the chunk
+};
+
+// what the blocks that are not cubes are drawn with, they come and go with the chunk model they stand in
+struct LevelProps
+{
+    Canis::GLTexture *grass = nullptr;
+    Canis::GLTexture *flower = nullptr;
+    Canis::GLTexture *fire = nullptr;
+    Canis::GLTexture *specular = nullptr;
+    Canis::Model *grassModel = nullptr;
+    Canis::Model *fireModel = nullptr;
+    Canis::Shader *grassShader = nullptr;
+    Canis::Shader *fireShader = nullptr;
+};
+
+// every handle LoadLevel took from the asset manager, released when the game closes
+struct LevelAssets
+{
+    std::vector<Canis::TextureHandle> textures = {};
+    std::vector<Canis::ModelHandle> models = {};
+};
 
 // declaring functions
 void SpawnLights(Canis::World &_world);
-void LoadMap(std::string _path);
-void Rotate(Canis::World &_world, Canis::Entity &_entity, float _deltaTime);
-void AnimateFire(Canis::World &_world, Canis::Entity &_entity, float _deltaTime);
-void RandomizeGrassAndFlowers(int startY, int endY, int startX, int endX, float grassChance, float flowerChance);
-void SetupRandomVegetation();
+void Rotate(Canis::World &_world, Canis::EntityHandle _entity, float _deltaTime);
+void AnimateFire(Canis::World &_world, Canis::EntityHandle _entity, float _deltaTime);
+Canis::Shader &SetupHelloShader(bool _wind, bool _instanced);
+Canis::Shader &SetupBlockShader();
+Canis::Shader &SetupFireShader(bool _instanced);
+void SetFireFrame(Canis::Shader &_shader, int _frame);
+Canis::Task<void> LoadLevel(Canis::World &_world, Canis::Shader &_grassShader, Canis::Shader &_fireShader, Canis::Shader &_blockShader,
+                            Canis::BlockRegistry &_blocks, std::unordered_map<uint64_t, ChunkModel> &_chunkModels, Canis::ChunkStreamer &_streamer,
+                            LevelAssets &_levelAssets);
+void ReleaseLevelAssets(LevelAssets &_levelAssets);
+void StartChunkStreaming(Canis::World &_world, Canis::BlockRegistry &_blocks, Canis::Shader &_shader, const LevelProps &_props,
+                         std::unordered_map<uint64_t, ChunkModel> &_chunkModels, Canis::ChunkStreamer &_streamer);
+void SpawnChunkProps(Canis::World &_world, const LevelProps &_props, ChunkModel &_chunkModel);
 
 // Fire animation parameters
-const int FIRE_FRAME_COUNT = 31;  // Number of fire frames (1-31)
-std::vector<Canis::GLTexture> fireTextures;
 float fireAnimTimer = 0.0f;
 int currentFireFrame = 0;
 const float FIRE_ANIM_SPEED = 0.05f;  // Seconds per frame
@@ -53,7 +104,31 @@ extern "C" int main(int argc, char* argv[])
 int main(int argc, char* argv[])
 #endif
 {
+    auto startupStart = std::chrono::high_resolution_clock::now();
+
     Canis::Init();
+
+    // --pack bundles assets/ into the pack project.canis names, run the game once before so the .cmesh and .ctex files go in too
+    if (argc > 1 && std::string(argv[1]) == "--pack")
+    {
+        std::string packPath = Canis::GetConfig().assetPack.empty() ? "assets.cpak" : Canis::GetConfig().assetPack;
+        Canis::UnmountAssetPack();
+        return Canis::BuildAssetPack("assets", packPath) ? 0 : 1;
+    }
+
+    // --convert-maps writes a .cmap next to every text .map in assets/maps, the game also converts a level that changed when it loads it
+    if (argc > 1 && std::string(argv[1]) == "--convert-maps")
+    {
+        bool converted = true;
+        for (const auto &file : std::filesystem::directory_iterator("assets/maps"))
+            if (file.path().extension() == ".map")
+                converted &= Canis::ConvertMap(file.path().generic_string(), std::filesystem::path(file.path()).replace_extension(".cmap").generic_string());
+        return converted ? 0 : 1;
+    }
+
+    if (Canis::GetConfig().benchmark)
+        return RunBenchmarks() ? 0 : 1;
+
     Canis::InputManager inputManager;
     Canis::FrameRateManager frameRateManager;
     frameRateManager.Init(60);
@@ -79,247 +154,82 @@ int main(int argc, char* argv[])
     Canis::Graphics::EnableDepthTest();
 
     /// SETUP SHADER
-    Canis::Shader shader;
-    shader.Compile("assets/shaders/hello_shader.vs", "assets/shaders/hello_shader.fs");
-    shader.AddAttribute("aPosition");
-    shader.Link();
-    shader.Use();
-    shader.SetInt("MATERIAL.diffuse", 0);
-    shader.SetInt("MATERIAL.specular", 1);
-    shader.SetFloat("MATERIAL.shininess", 64);
-    shader.SetBool("WIND", false);
-    shader.UnUse();
+    // every shader gets an INSTANCED variant so World can draw whole batches at once
+    Canis::Shader &shader = SetupHelloShader(false, false);
+    shader.SetInstancedVariant(&SetupHelloShader(false, true));
+
+    // wind is a define so the grass shader is its own program
+    Canis::Shader &grassShader = SetupHelloShader(true, false);
+    grassShader.SetInstancedVariant(&SetupHelloShader(true, true));
 
-    Canis::Shader grassShader;
-    grassShader.Compile("assets/shaders/hello_shader.vs", "assets/shaders/hello_shader.fs");
-    grassShader.AddAttribute("aPosition");
-    grassShader.Link();
-    grassShader.Use();
-    grassShader.SetInt("MATERIAL.diffuse", 0);
-    grassShader.SetInt("MATERIAL.specular", 1);
-    grassShader.SetFloat("MATERIAL.shininess", 64);
-    grassShader.SetBool("WIND", true);
-    grassShader.SetFloat("WINDEFFECT", 0.2);
-    grassShader.UnUse();
-
-    // Flat shader for blocks with different textures on different faces
-    Canis::Shader flatShader;
-    flatShader.Compile("assets/shaders/block_flat.vs", "assets/shaders/block_flat.fs");
-    flatShader.AddAttribute("aPosition");
-    flatShader.AddAttribute("aNormal");
-    flatShader.AddAttribute("aTexCoords");
-    flatShader.Link();
-    flatShader.Use();
-    flatShader.SetInt("uSideTex", 0);    // side texture unit
-    flatShader.SetInt("uTopTex", 1);     // top texture unit
-    flatShader.SetInt("uBottomTex", 2);  // bottom texture unit
-    
-    // Add lighting uniforms to flatShader
-    // Set lighting properties for the flat shader
-    flatShader.SetFloat("MATERIAL.shininess", 64.0f);
-    flatShader.UnUse();
+    // Chunk shader for every cube block, each chunk is its own model so there is nothing to instance
+    Canis::Shader &blockShader = SetupBlockShader();
 
     // Fire shader setup - simplified
-    Canis::Shader fireShader;
-    fireShader.Compile("assets/shaders/fire_shader.vs", "assets/shaders/fire_shader.fs");
-    fireShader.AddAttribute("aPosition");
-    fireShader.AddAttribute("aNormal");
-    fireShader.AddAttribute("aUV");
-    fireShader.Link();
-    fireShader.Use();
-    fireShader.SetInt("MATERIAL.diffuse", 0);          // Now using single texture
-    fireShader.SetInt("MATERIAL.specular", 1);         // Specular map
-    fireShader.SetFloat("MATERIAL.shininess", 32.0f);  // Lower shininess for fire
-    fireShader.UnUse();
+    Canis::Shader &fireShader = SetupFireShader(false);
+    Canis::Shader &fireShaderInstanced = SetupFireShader(true);
+    fireShader.SetInstancedVariant(&fireShaderInstanced);
     /// END OF SHADER
 
-    /// Load Image
-    Canis::GLTexture glassTexture = Canis::LoadImageGL("assets/textures/glass.png", true);
-    Canis::GLTexture grassTexture = Canis::LoadImageGL("assets/textures/grass.png", false);
-    Canis::GLTexture flowerTexture = Canis::LoadImageGL("assets/textures/blue_orchid.png", false);
-
-    Canis::GLTexture woodplankTexture = Canis::LoadImageGL("assets/textures/oak_planks.png", true);
-
-    Canis::GLTexture houseTexture = Canis::LoadImageGL("assets/textures/house.png", true);
-
-    
-    // Dirt block textures
-    Canis::GLTexture dirtSideTex = Canis::LoadImageGL("assets/textures/grass_block_side.png", false);
-    Canis::GLTexture dirtTopTex = Canis::LoadImageGL("assets/textures/grass_block_top.png", false);
-    Canis::GLTexture dirtBottomTex = Canis::LoadImageGL("assets/textures/dirt_bottom.png", false); // Changed to dirt.png for bottom
-
-    Canis::GLTexture brickblock = Canis::LoadImageGL("assets/textures/bricks.png", true);
-
-    Canis::GLTexture textureSpecular = Canis::LoadImageGL("assets/textures/container2_specular.png", true);
-
-    // Load fire textures with verification
-    fireTextures.clear(); // Make sure vector is empty
-    for (int i = 1; i <= FIRE_FRAME_COUNT; i++) {
-        std::string path = "assets/textures/fire_textures/fire_" + std::to_string(i) + ".png";
-        Canis::GLTexture fireTexture = Canis::LoadImageGL(path, true); // Enable transparency for fire
-        
-        // Verify the texture loaded correctly
-        if (fireTexture.id == 0) {
-            Canis::Log("Failed to load fire texture: " + path);
-        } else {
-            Canis::Log("Successfully loaded fire texture: " + path);
-        }
-        
-        fireTextures.push_back(fireTexture);
-    }
-    /// End of Image Loading
-
-    /// Load Models
-    Canis::Model cubeModel = Canis::LoadModel("assets/models/cube.obj");
-    Canis::Model grassModel = Canis::LoadModel("assets/models/plants.obj");
-    Canis::Model fireModel = Canis::LoadModel("assets/models/fire.obj");
-    /// END OF LOADING MODEL
-
-    // Load Map into 3d array
-    LoadMap("assets/maps/level.map");
-    
-    // Add this line to randomize grass and flowers in the specified region
-    SetupRandomVegetation();
-
-    // Loop map and spawn objects
-    for (int y = 0; y < map.size(); y++)
-    {
-        for (int x = 0; x < map[y].size(); x++)
-        {
-            for (int z = 0; z < map[y][x].size(); z++)
-            {
-                Canis::Entity entity;
-                entity.active = true;
+    /// Load Level
+    // the level loads while the frame loop below runs, see LoadLevel
+    Canis::BlockRegistry blocks;
+    // unordered_map keeps the models in place for the entities pointing at them
+    std::unordered_map<uint64_t, ChunkModel> chunkModels;
+    Canis::MeshingMode meshingMode = Canis::GetConfig().greedyMeshing ? Canis::MeshingMode::GREEDY : Canis::MeshingMode::PER_FACE;
 
-                switch (map[y][x][z])
-                {
-                case 1: // places a glass block
-                    entity.tag = "glass";
-                    entity.albedo = &glassTexture;
-                    entity.specular = &textureSpecular;
-                    entity.model = &cubeModel;
-                    entity.shader = &shader;
-                    entity.transform.position = vec3(x + 0.0f, y + 0.0f, z + 0.0f);
-                    world.Spawn(entity);
-                    break;
-                case 2: // places a grass block
-                    entity.tag = "grass";
-                    entity.albedo = &grassTexture;
-                    entity.specular = &textureSpecular;
-                    entity.model = &grassModel;
-                    entity.shader = &grassShader;
-                    entity.transform.position = vec3(x + 0.0f, y + 0.0f, z + 0.0f);
-                    entity.Update = &Rotate;
-                    world.Spawn(entity);
-                    break;
-                case 3: // places a woodenplank block
-                    entity.tag = "oakplank";
-                    entity.albedo = &woodplankTexture;
-                    entity.specular = &textureSpecular;
-                    entity.model = &cubeModel;
-                    entity.shader = &shader;
-                    entity.transform.position = vec3(x + 0.0f, y + 0.0f, z + 0.0f);
-                    entity.Update = &Rotate;
-                    world.Spawn(entity);
-                    break;
-                case 4: // places a dirt block with different textures on top, sides, and bottom
-                    entity.tag = "dirt";
-                    entity.albedo = &dirtSideTex;     // side texture (GL_TEXTURE0)
-                    entity.specular = &dirtTopTex;    // top texture (GL_TEXTURE1)
-                    entity.emission = &dirtBottomTex; // bottom texture (GL_TEXTURE2)
-                    entity.model = &cubeModel;
-                    entity.shader = &flatShader;      // Use the flat shader for multi-texture blocks
-                    entity.transform.position = vec3(x + 0.0f, y + 0.0f, z + 0.0f);
-                    world.Spawn(entity);
-                    break;
-                case 5: // places a brick block
-                    entity.tag = "brick";
-                    entity.albedo = &brickblock;
-                    entity.specular = &textureSpecular;
-                    entity.model = &cubeModel;
-                    entity.shader = &shader;
-                    entity.transform.position = vec3(x + 0.0f, y + 0.0f, z + 0.0f);
-                    entity.Update = &Rotate;
-                    world.Spawn(entity);
-                    break;
-                case 6: // places a flower
-                    entity.tag = "flower";
-                    entity.albedo = &flowerTexture;
-                    entity.specular = &textureSpecular;
-                    entity.model = &grassModel;
-                    entity.shader = &grassShader;
-                    entity.transform.position = vec3(x + 0.0f, y + 0.0f, z + 0.0f);
-                    entity.Update = &Rotate;
-                    world.Spawn(entity);
-                    break;
-                case 7: // places a fire
-                    entity.tag = "fire";
-                    entity.albedo = &fireTextures[0];   // Initial texture is the first frame
-                    entity.specular = &textureSpecular;
-                    entity.model = &fireModel;
-                    entity.shader = &fireShader;
-                    entity.transform.position = vec3(x + 0.0f, y + 0.0f, z + 0.0f);
-                    entity.Update = &AnimateFire;
-                    world.Spawn(entity);
-                    break;
-                case 8: // places a special house block
-                    entity.tag = "house";
-                    entity.albedo = &houseTexture;
-                    entity.specular = &textureSpecular;
-                    entity.model = &cubeModel;
-                    entity.shader = &shader;
-                    entity.transform.position = vec3(x + 0.0f, y + 0.0f, z + 0.0f);
-                    entity.Update = &Rotate;
-                    world.Spawn(entity);
-                default:
-                    break;
-                }
-            }
-        }
-    }
+    // the chunks around the camera are meshed on the thread pool once LoadLevel starts the streamer
+    Canis::ChunkStreamer streamer;
+    LevelAssets levelAssets;
+    streamer.SetRadius(Canis::GetConfig().streamRadius);
+    streamer.SetBudget(Canis::GetConfig().streamBudget);
+    streamer.SetMode(meshingMode);
+    editor.SetChunkStreamer(&streamer);
 
-    // Add some example fire entities in the scene
-    Canis::Entity fire1;
-    fire1.active = true;
-    fire1.tag = "fire";
-    fire1.albedo = &fireTextures[0];
-    fire1.specular = &textureSpecular;
-    fire1.model = &fireModel;
-    fire1.shader = &fireShader;
-    fire1.transform.position = vec3(5.0f, 1.0f, 5.0f);
-    fire1.Update = &AnimateFire;
-    world.Spawn(fire1);
+    Canis::TaskScheduler &tasks = Canis::GetTaskScheduler();
+    tasks.Spawn(LoadLevel(world, grassShader, fireShader, blockShader, blocks, chunkModels, streamer, levelAssets));
+    /// End of Level Loading
 
-    Canis::Entity fire2;
-    fire2.active = true;
-    fire2.tag = "fire";
-    fire2.albedo = &fireTextures[0];
-    fire2.specular = &textureSpecular;
-    fire2.model = &fireModel;
-    fire2.shader = &fireShader;
-    fire2.transform.position = vec3(3.0f, 1.0f, 7.0f);
-    fire2.Update = &AnimateFire;
-    world.Spawn(fire2);
+    Canis::Log("Startup: " + std::to_string(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startupStart).count() * 1000.0) + " ms");
 
     double deltaTime = 0.0;
     double fps = 0.0;
 
+    // frames drawn while the level loads, the worst one shows whether loading hitches
+    bool loading = true;
+    int loadingFrames = 0;
+    double worstLoadingFrame = 0.0;
+
     // Application loop
     while (inputManager.Update(Canis::GetConfig().width, Canis::GetConfig().heigth))
     {
+        auto frameStart = std::chrono::high_resolution_clock::now();
         deltaTime = frameRateManager.StartFrame();
         Canis::Graphics::ClearBuffer(COLOR_BUFFER_BIT | DEPTH_BUFFER_BIT);
 
+        // continues LoadLevel and anything else waiting for the gl thread
+        tasks.Update();
+        streamer.Update(world.GetCamera().Position);
+
         // Update fire animation globally
         fireAnimTimer += deltaTime;
         if (fireAnimTimer >= FIRE_ANIM_SPEED) {
             fireAnimTimer -= FIRE_ANIM_SPEED; // Subtract instead of resetting to avoid timing drift
             currentFireFrame = (currentFireFrame + 1) % FIRE_FRAME_COUNT;
+            SetFireFrame(fireShader, currentFireFrame);
+            SetFireFrame(fireShaderInstanced, currentFireFrame);
             
             // Log for debugging
             Canis::Log("Fire animation frame: " + std::to_string(currentFireFrame));
         }
 
+        // M switches between greedy and per face chunk meshes, the old meshes stay until the new ones are streamed in
+        if (inputManager.JustPressedKey(SDLK_m))
+        {
+            meshingMode = (meshingMode == Canis::MeshingMode::GREEDY) ? Canis::MeshingMode::PER_FACE : Canis::MeshingMode::GREEDY;
+            streamer.SetMode(meshingMode);
+        }
+
         world.Update(deltaTime);
         world.Draw(deltaTime);
 
@@ -327,110 +237,344 @@ int main(int argc, char* argv[])
 
         window.SwapBuffer();
 
+        if (loading)
+        {
+            loadingFrames++;
+            worstLoadingFrame = std::max(worstLoadingFrame, std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - frameStart).count());
+
+            if (tasks.GetRunningCount() == 0)
+            {
+                loading = false;
+                Canis::Log("Level loaded over " + std::to_string(loadingFrames) + " frames, worst frame " + std::to_string(worstLoadingFrame * 1000.0) + " ms");
+            }
+        }
+
         // EndFrame will pause the app when running faster than frame limit
         fps = frameRateManager.EndFrame();
 
         //Canis::Log("FPS: " + std::to_string(fps) + " DeltaTime: " + std::to_string(deltaTime));
     }
 
+    // the chunk models and props point at the level assets, so they go first
+    streamer.Stop();
+    ReleaseLevelAssets(levelAssets);
+    blocks.ReleaseTextures();
+
     return 0;
 }
 
-void Rotate(Canis::World &_world, Canis::Entity &_entity, float _deltaTime)
+// the demo level, written in order but spread over frames, every co_await hands the frame back to the loop
+// decoding, map parsing and meshing run on the thread pool, the gl uploads run here between frames
+Canis::Task<void> LoadLevel(Canis::World &_world, Canis::Shader &_grassShader, Canis::Shader &_fireShader, Canis::Shader &_blockShader,
+                            Canis::BlockRegistry &_blocks, std::unordered_map<uint64_t, ChunkModel> &_chunkModels, Canis::ChunkStreamer &_streamer,
+                            LevelAssets &_levelAssets)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    Canis::AssetManager &assets = Canis::GetAssetManager();
+
+    std::vector<Canis::TextureRequest> textureRequests = GetLevelTextures();
+    std::vector<std::string> firePaths = GetFirePaths();
+    SetupBlocks(_blocks);
+
+    // the loads below then only map the .ctex and .cmesh files and upload
+    auto prepare = [&]() { PrepareLevelAssets(GetLevelImagePaths(_blocks), Canis::GetConfig().textureCache, Canis::GetConfig().meshCache); };
+    co_await Canis::RunOnPool(prepare);
+
+    /// Load Image
+    std::vector<Canis::TextureHandle> textures = assets.LoadTextures(textureRequests);
+    _levelAssets.textures = textures;
+
+    Canis::GLTexture &grassTexture = assets.Get(textures[0]);
+    Canis::GLTexture &flowerTexture = assets.Get(textures[1]);
+    Canis::GLTexture &textureSpecular = assets.Get(textures[2]);
+    co_await Canis::NextFrame();
+
+    // every face of the cube blocks goes into one texture array
+    _blocks.LoadTextures();
+    co_await Canis::NextFrame();
+
+    // all fire entities share the flipbook, the frame is picked in fire_shader
+    _levelAssets.textures.push_back(assets.LoadTextureArray(firePaths, true));
+    Canis::GLTexture &fireFlipbook = assets.Get(_levelAssets.textures.back()); // Enable transparency for fire
+    co_await Canis::NextFrame();
+    /// End of Image Loading
+
+    /// Load Models
+    _levelAssets.models.push_back(assets.LoadModel("assets/models/plants.obj"));
+    _levelAssets.models.push_back(assets.LoadModel("assets/models/fire.obj"));
+    Canis::Model &grassModel = assets.Get(_levelAssets.models[0]);
+    Canis::Model &fireModel = assets.Get(_levelAssets.models[1]);
+    /// END OF LOADING MODEL
+
+    // Load Map into the voxel grid
+    auto loadMap = []() { return LoadLevelMap(); };
+    if (!co_await Canis::RunOnPool(loadMap))
+    {
+        Canis::Error("Level map could not be loaded, the level stays empty");
+        co_return;
+    }
+
+    LevelProps props;
+    props.grass = &grassTexture;
+    props.flower = &flowerTexture;
+    props.fire = &fireFlipbook;
+    props.specular = &textureSpecular;
+    props.grassModel = &grassModel;
+    props.fireModel = &fireModel;
+    props.grassShader = &_grassShader;
+    props.fireShader = &_fireShader;
+
+    // Mesh the cube blocks around the camera from now on, the blocks that are not cubes are spawned with their chunk
+    StartChunkStreaming(_world, _blocks, _blockShader, props, _chunkModels, _streamer);
+
+    // Add some example fire entities in the scene
+    Canis::Entity fire1;
+    fire1.active = true;
+    fire1.tag = "fire";
+    fire1.albedo = &fireFlipbook;
+    fire1.specular = &textureSpecular;
+    fire1.model = &fireModel;
+    fire1.shader = &_fireShader;
+    fire1.transparent = true;
+    fire1.transform.position = vec3(5.0f, 1.0f, 5.0f);
+    fire1.Update = &AnimateFire;
+    _world.Spawn(fire1);
+
+    Canis::Entity fire2;
+    fire2.active = true;
+    fire2.tag = "fire";
+    fire2.albedo = &fireFlipbook;
+    fire2.specular = &textureSpecular;
+    fire2.model = &fireModel;
+    fire2.shader = &_fireShader;
+    fire2.transparent = true;
+    fire2.transform.position = vec3(3.0f, 1.0f, 7.0f);
+    fire2.Update = &AnimateFire;
+    _world.Spawn(fire2);
+
+    Canis::Log("Level: " + std::to_string(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() * 1000.0) + " ms");
+    assets.LogAssets();
+}
+
+void ReleaseLevelAssets(LevelAssets &_levelAssets)
+{
+    Canis::AssetManager &assets = Canis::GetAssetManager();
+    for (Canis::TextureHandle texture : _levelAssets.textures)
+        assets.Release(texture);
+    for (Canis::ModelHandle model : _levelAssets.models)
+        assets.Release(model);
+    _levelAssets = LevelAssets();
+}
+
+void Rotate(Canis::World &_world, Canis::EntityHandle _entity, float _deltaTime)
 {
-    //_entity.transform.rotation.y += _deltaTime;
+    //Canis::Transform &transform = _world.GetTransform(_entity);
+    //transform.SetRotation(transform.rotation + vec3(0.0f, _deltaTime, 0.0f));
 }
 
-void AnimateFire(Canis::World &_world, Canis::Entity &_entity, float _deltaTime)
+void AnimateFire(Canis::World &_world, Canis::EntityHandle _entity, float _deltaTime)
 {
-    // Update the entity's texture to match the current global frame
-    _entity.albedo = &fireTextures[currentFireFrame];
-    
+    // the frame itself comes from the FRAME uniform so every fire stays in one batch
+
     // Optional: Make fire flicker a bit to add realism
     float flicker = 0.9f + 0.1f * sin(_world.GetTime() * 10.0f);
-    _entity.transform.scale = vec3(1.0f, flicker, 1.0f);
+    _world.GetTransform(_entity).SetScale(vec3(1.0f, flicker, 1.0f));
 }
 
-// Function to randomly place flowers and grass in a specific area of the map
-void RandomizeGrassAndFlowers(int startY, int endY, int startX, int endX, float grassChance = 0.4f, float flowerChance = 0.3f)
+// shaders come from the asset manager, a second setup with the same defines gets the same program
+Canis::Shader &SetupHelloShader(bool _wind, bool _instanced)
 {
-    // Verify the map is properly loaded
-    if (map.size() < 2 || map[1].size() < endY || map[1][0].size() < endX) {
-        Canis::Log("Error: Map is not properly loaded or specified region is out of bounds.");
-        return;
-    }
+    std::vector<std::string> defines;
+    if (_instanced)
+        defines.push_back("INSTANCED");
+    if (_wind)
+        defines.push_back("WIND");
+
+    Canis::AssetManager &assets = Canis::GetAssetManager();
+    Canis::Shader &shader = assets.Get(assets.LoadShader("assets/shaders/hello_shader.vs", "assets/shaders/hello_shader.fs",
+                                                          {"aPosition", "aNormal", "aUV"}, defines));
+    shader.Use();
+    shader.SetInt("MATERIAL.diffuse", 0);
+    shader.SetInt("MATERIAL.specular", 1);
+    shader.SetFloat("MATERIAL.shininess", 64);
+    if (_wind)
+        shader.SetFloat("WINDEFFECT", 0.2);
+    shader.UnUse();
+    return shader;
+}
 
-    // Make sure to seed the random number generator
-    srand(static_cast<unsigned int>(time(nullptr)));
-
-    // For each position in the specified region (second level = index 1)
-    for (int y = startY; y < endY; y++) {
-        for (int x = startX; x < endX; x++) {
-            // Check if the current position is within array bounds
-            if (y < map[1].size() && x < map[1][y].size()) {
-                // Generate a random value between 0 and 1
-                float randomValue = static_cast<float>(rand()) / RAND_MAX;
-                
-                if (randomValue < grassChance) {
-                    // Place grass (2)
-                    map[1][y][x] = 2;
-                    Canis::Log("Placed grass at [1][" + std::to_string(y) + "][" + std::to_string(x) + "]");
-                } else if (randomValue < (grassChance + flowerChance)) {
-                    // Place flower (6)
-                    map[1][y][x] = 6;
-                    Canis::Log("Placed flower at [1][" + std::to_string(y) + "][" + std::to_string(x) + "]");
-                } else {
-                    // Leave empty (0) - this gives a chance for some spots to remain empty
-                    map[1][y][x] = 0;
-                    Canis::Log("Left empty at [1][" + std::to_string(y) + "][" + std::to_string(x) + "]");
-                }
-            }
-        }
-    }
+Canis::Shader &SetupBlockShader()
+{
+    Canis::AssetManager &assets = Canis::GetAssetManager();
+    Canis::Shader &shader = assets.Get(assets.LoadShader("assets/shaders/block_array.vs", "assets/shaders/block_array.fs",
+                                                          {"aPosition", "aNormal", "aUV"}));
+    shader.Use();
+    shader.SetInt("MATERIAL.diffuse", 0);  // block texture array
+    shader.SetInt("MATERIAL.specular", 1);
+    shader.SetFloat("MATERIAL.shininess", 64);
+    shader.UnUse();
+    return shader;
+}
+
+Canis::Shader &SetupFireShader(bool _instanced)
+{
+    std::vector<std::string> defines;
+    if (_instanced)
+        defines.push_back("INSTANCED");
+
+    Canis::AssetManager &assets = Canis::GetAssetManager();
+    Canis::Shader &shader = assets.Get(assets.LoadShader("assets/shaders/fire_shader.vs", "assets/shaders/fire_shader.fs",
+                                                          {"aPosition", "aNormal", "aUV"}, defines));
+    shader.Use();
+    shader.SetInt("MATERIAL.diffuse", 0);          // Flipbook texture array
+    shader.SetInt("FRAME", 0);
+    shader.SetInt("MATERIAL.specular", 1);         // Specular map
+    shader.SetFloat("MATERIAL.shininess", 32.0f);  // Lower shininess for fire
+    shader.UnUse();
+    return shader;
 }
 
-// This function should be called after LoadMap and before entity spawning
-void SetupRandomVegetation()
+void SetFireFrame(Canis::Shader &_shader, int _frame)
 {
-    // Randomize grass and flowers in the 5x5 section on level 1 (index 1 in map array)
-    // Parameters: startY, endY, startX, endX, grassChance, flowerChance
-    RandomizeGrassAndFlowers(5, 10, 15, 20, 0.4f, 0.3f);
+    _shader.Use();
+    _shader.SetInt("FRAME", _frame);
+    _shader.UnUse();
 }
 
-void LoadMap(std::string _path)
+// chunk models follow the camera, each one is created on the gl thread when its mesh arrives and freed when it is evicted
+// the props of a chunk come with its first load, a chunk with no cube faces is loaded without vertices so its props still show up
+void StartChunkStreaming(Canis::World &_world, Canis::BlockRegistry &_blocks, Canis::Shader &_shader, const LevelProps &_props,
+                         std::unordered_map<uint64_t, ChunkModel> &_chunkModels, Canis::ChunkStreamer &_streamer)
 {
-    std::ifstream file;
-    file.open(_path);
+    Canis::World *world = &_world;
+    Canis::BlockRegistry *blocks = &_blocks;
+    Canis::Shader *shader = &_shader;
+    LevelProps props = _props;
+    std::unordered_map<uint64_t, ChunkModel> *chunkModels = &_chunkModels;
+
+    // the map is only read while the streamer runs
+    auto fill = [](glm::ivec3 _chunk, uint8_t *_paddedBlocks) { map.CopyPaddedChunk(_chunk, _paddedBlocks); };
 
-    if (!file.is_open())
+    auto load = [=](glm::ivec3 _chunk, const std::vector<float> &_vertices)
     {
-        printf("file not found at: %s \n", _path.c_str());
-        exit(1);
-    }
+        uint64_t key = Canis::ChunkKey(_chunk);
+        auto found = chunkModels->find(key);
+        if (found == chunkModels->end())
+        {
+            found = chunkModels->emplace(key, ChunkModel()).first;
+            found->second.chunk = _chunk;
+            SpawnChunkProps(*world, props, found->second);
+        }
 
-    int number = 0;
-    int layer = 0;
+        ChunkModel &chunkModel = found->second;
 
-    map.push_back(std::vector<std::vector<unsigned int>>());
-    map[layer].push_back(std::vector<unsigned int>());
+        // remeshed without faces, the props stay
+        if (_vertices.empty())
+        {
+            if (chunkModel.meshed)
+            {
+                world->Despawn(chunkModel.entity);
+                Canis::UnloadModel(chunkModel.model);
+                chunkModel.meshed = false;
+            }
+            return;
+        }
 
-    while (file >> number)
-    {
-        if (number == -2) // add new layer
+        if (chunkModel.meshed)
         {
-            layer++;
-            map.push_back(std::vector<std::vector<unsigned int>>());
-            map[map.size() - 1].push_back(std::vector<unsigned int>());
-            continue;
+            Canis::UpdateModel(chunkModel.model, _vertices);
+            return;
         }
 
-        if (number == -1) // add new row
+        chunkModel.meshed = true;
+        chunkModel.model = Canis::CreateModel(_vertices, "chunk", Canis::CHUNK_VERTEX_ATTRIBUTES, 4);
+
+        // every chunk shares the shader and the block texture array
+        Canis::Entity entity;
+        entity.active = true;
+        entity.tag = "chunk";
+        entity.shader = shader;
+        entity.albedo = &blocks->GetTextureArray();
+        entity.specular = props.specular;
+        entity.model = &chunkModel.model;
+        entity.transform.position = vec3(_chunk * Canis::CHUNK_SIZE);
+
+        // a chunk with glass is blended as a whole after the opaque chunks
+        const Canis::BlockInfo *blockInfo = blocks->GetBlockInfo();
+        const uint8_t *chunkBlocks = map.GetChunkData(_chunk);
+        for (int i = 0; i < Canis::VoxelGrid::CHUNK_VOLUME && !entity.transparent; i++)
+            entity.transparent = blockInfo[chunkBlocks[i]].cube && blockInfo[chunkBlocks[i]].transparent;
+
+        chunkModel.entity = world->Spawn(entity);
+    };
+
+    auto evict = [=](glm::ivec3 _chunk)
+    {
+        auto found = chunkModels->find(Canis::ChunkKey(_chunk));
+        if (found == chunkModels->end())
+            return;
+
+        if (found->second.meshed)
         {
-            map[map.size() - 1].push_back(std::vector<unsigned int>());
-            continue;
+            world->Despawn(found->second.entity);
+            Canis::UnloadModel(found->second.model);
         }
+        for (Canis::EntityHandle prop : found->second.props)
+            world->Despawn(prop);
+        chunkModels->erase(found);
+    };
+
+    _streamer.Start(_blocks.GetBlockInfo(), fill, load, evict, glm::ivec3(0), map.GetChunkCount());
+}
+
+// spawns an entity for every grass, flower and fire block of the chunk
+void SpawnChunkProps(Canis::World &_world, const LevelProps &_props, ChunkModel &_chunkModel)
+{
+    glm::ivec3 start = _chunkModel.chunk * Canis::CHUNK_SIZE;
+    glm::ivec3 end = glm::min(start + Canis::CHUNK_SIZE, glm::ivec3(map.GetSizeX(), map.GetSizeY(), map.GetSizeZ()));
+
+    for (int y = start.y; y < end.y; y++)
+    {
+        for (int x = start.x; x < end.x; x++)
+        {
+            for (int z = start.z; z < end.z; z++)
+            {
+                Canis::Entity entity;
+                entity.active = true;
+                entity.specular = _props.specular;
+                entity.transform.position = vec3(x + 0.0f, y + 0.0f, z + 0.0f);
 
-        map[map.size() - 1][map[map.size() - 1].size() - 1].push_back((unsigned int)number);
+                switch (map.Get(x, y, z))
+                {
+                case 2: // places a grass block
+                    entity.tag = "grass";
+                    entity.albedo = _props.grass;
+                    entity.model = _props.grassModel;
+                    entity.shader = _props.grassShader;
+                    entity.Update = &Rotate;
+                    break;
+                case 6: // places a flower
+                    entity.tag = "flower";
+                    entity.albedo = _props.flower;
+                    entity.model = _props.grassModel;
+                    entity.shader = _props.grassShader;
+                    entity.Update = &Rotate;
+                    break;
+                case 7: // places a fire
+                    entity.tag = "fire";
+                    entity.albedo = _props.fire;
+                    entity.model = _props.fireModel;
+                    entity.shader = _props.fireShader;
+                    entity.transparent = true;
+                    entity.Update = &AnimateFire;
+                    break;
+                default:
+                    continue;
+                }
+
+                _chunkModel.props.push_back(_world.Spawn(entity));
+            }
+        }
     }
 }
 